@@ -87,6 +87,16 @@ expect "lateral over empty input relation" \
 	"SELECT count(*) FROM (SELECT 'x' WHERE 1=0) v(cmd), read_lines_lateral(v.cmd) l;" \
 	"0"
 
+expect "several pipes in one scan" \
+	"SELECT file_path || ':' || count(*)
+	 FROM read_lines(['seq 1 3000 |', 'printf \"a\nb\" |', 'seq 1 10 |'])
+	 GROUP BY ALL ORDER BY 1;" \
+	$'printf "a\\nb" |:2\nseq 1 10 |:10\nseq 1 3000 |:3000'
+
+expect "pipes run concurrently, first output first" \
+	"SELECT first(file_path) FROM read_lines(['sleep 1; echo slow |', 'echo fast |']);" \
+	"echo fast |"
+
 if [[ "$FAILURES" -gt 0 ]]; then
 	echo "$FAILURES pipe smoke test(s) FAILED"
 	exit 1
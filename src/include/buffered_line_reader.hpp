@@ -0,0 +1,223 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "read_lines_extension.hpp"
+#include "line_source.hpp"
+
+namespace duckdb {
+
+// =============================================================================
+// BufferedLineReader
+//
+// The single reading path for every source, seekable or not. Reads the source
+// in large chunks (one FileHandle::Read call per chunk instead of the previous
+// syscall-per-byte ReadLine loop) and splits lines with the shared ExtractLine,
+// so files, pipes, and parse_lines all agree on the same bytes:
+//   - terminators (\n, \r\n, lone \r) are separators AND are preserved in the
+//     returned content, as the README documents;
+//   - a terminator-final stream does not grow a phantom trailing line, and a
+//     trailing empty line ("a\n\n") is not silently dropped;
+//   - a UTF-8 BOM at the start of the stream is skipped, not leaked into the
+//     first line's content (byte offsets remain true source offsets, so the
+//     first line of a BOM'd file starts at offset 3);
+//   - end of stream is a 0-byte Read(), which works for pipes and virtual
+//     URIs where SeekPosition()/GetFileSize() throw.
+// Memory stays bounded (about twice the longest line plus one read) because
+// consumed bytes are compacted away once they outweigh the live ones —
+// except after SlurpAll(), which deliberately buffers the whole stream to
+// resolve from-end references on sources that cannot rewind.
+//
+// Reads adapt to the source: a read that comes back full doubles the next
+// request (up to MAX_READ_SIZE), so fast sources take few large reads, and
+// one that comes back mostly empty halves it, so a trickling pipe does not
+// grow the buffer for nothing.
+// =============================================================================
+class BufferedLineReader {
+public:
+	explicit BufferedLineReader(FileHandle &file) : file(&file) {
+	}
+
+	// Resume mid-source: the caller has already positioned `file` at
+	// `start_offset`, which must be the start of a line (e.g. an index block
+	// boundary). Offsets stay true source offsets; no BOM check is made.
+	BufferedLineReader(FileHandle &file, int64_t start_offset)
+	    : file(&file), buffer_base(start_offset), bom_checked(start_offset > 0) {
+	}
+
+	// Read a decompressing (or otherwise transformed) source; offsets are
+	// offsets in the bytes it produces.
+	explicit BufferedLineReader(LineSource &source) : source(&source) {
+	}
+
+	// Snapshot reads: never read past source offset `end_offset` (-1: read
+	// to the end), even if the source grows meanwhile, and with
+	// `complete_lines` leave out a last line without a terminator, which a
+	// writer may still be appending to.
+	void SetSnapshot(int64_t end_offset, bool complete_lines_only) {
+		snapshot_end = end_offset;
+		complete_lines = complete_lines_only;
+	}
+
+	// Extract the next line, including its terminator, as a view into the
+	// buffer that stays valid until the next call. Returns false at end of
+	// stream. start_offset is the byte offset of the line's first content byte
+	// in the source.
+	bool NextLine(const char *&line, idx_t &line_size, int64_t &start_offset) {
+		if (!EnsureLineBuffered()) {
+			return false;
+		}
+		start_offset = buffer_base + static_cast<int64_t>(pos);
+		auto end = FindLineEnd(buffer.data(), buffer.size(), pos);
+		line = buffer.data() + pos;
+		line_size = end - pos;
+		pos = end;
+		return true;
+	}
+
+	// Whether NextLine() can return without reading the source: a whole line
+	// is buffered, or the stream has ended.
+	bool HasBufferedLine() const {
+		if (eof) {
+			return true;
+		}
+		if (!bom_checked) {
+			return false;
+		}
+		auto term = buffer.find_first_of("\r\n", MaxValue(pos, scan_pos));
+		return term != string::npos && !(buffer[term] == '\r' && term + 1 == buffer.size());
+	}
+
+	// One read from the source into the buffer, for a caller that waits on
+	// the source itself (a flush deadline): after LineSource::WaitReady()
+	// returned true it does not block. A partial line stays buffered for the
+	// NextLine() that finds its end.
+	void FillReady() {
+		Fill();
+		if (!bom_checked && (buffer.size() >= 3 || eof)) {
+			SkipBOM();
+		}
+	}
+
+	// Buffer the whole remaining stream. Needed before CountBufferedLines() on
+	// non-seekable sources, which cannot be rewound after counting.
+	void SlurpAll() {
+		SkipBOM();
+		while (!eof) {
+			Fill();
+		}
+	}
+
+	// Lines from the current position to end of stream. Call after SlurpAll()
+	// and before any NextLine().
+	int64_t CountBufferedLines() const {
+		auto count = CountLinesInText(buffer, pos);
+		if (complete_lines && pos < buffer.size() && buffer.back() != '\n' && buffer.back() != '\r') {
+			count--;
+		}
+		return count;
+	}
+
+private:
+	static constexpr idx_t MIN_READ_SIZE = 65536;
+	static constexpr idx_t MAX_READ_SIZE = 1 << 20;
+
+	// Ensure the buffer holds a complete line starting at pos (or the final
+	// unterminated line once eof is reached). Returns false at end of stream.
+	bool EnsureLineBuffered() {
+		SkipBOM();
+		while (true) {
+			// Bytes before scan_pos were already searched for this line, so a
+			// long line arriving in small reads is not rescanned on each fill
+			auto term = buffer.find_first_of("\r\n", MaxValue(pos, scan_pos));
+			if (term != string::npos) {
+				// A '\r' as the last buffered byte may be the first half of a
+				// '\r\n' spanning a read boundary; decide after the next fill.
+				if (buffer[term] == '\r' && term + 1 == buffer.size() && !eof) {
+					scan_pos = term;
+					Fill();
+					continue;
+				}
+				return true;
+			}
+			if (eof) {
+				return pos < buffer.size() && !complete_lines;
+			}
+			scan_pos = buffer.size();
+			Fill();
+		}
+	}
+
+	// Skip a UTF-8 byte-order mark at the very start of the stream. Runs
+	// before the first line is parsed and never again.
+	void SkipBOM() {
+		while (!bom_checked) {
+			if (buffer.size() >= 3) {
+				if (buffer.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+					pos = 3;
+				}
+				bom_checked = true;
+			} else if (eof) {
+				bom_checked = true;
+			} else {
+				Fill();
+			}
+		}
+	}
+
+	void Fill() {
+		if (eof) {
+			return;
+		}
+		// Compact consumed bytes so streaming reads don't accumulate the whole
+		// source, but only once they are at least half the buffer: each byte
+		// is then moved a bounded number of times. pos stays 0-based within
+		// the buffer; buffer_base keeps start offsets equal to true source
+		// offsets.
+		if (pos > 0 && pos >= buffer.size() - pos) {
+			buffer.erase(0, pos);
+			buffer_base += static_cast<int64_t>(pos);
+			scan_pos -= MinValue(scan_pos, pos);
+			pos = 0;
+		}
+		auto request = read_size;
+		if (snapshot_end >= 0) {
+			auto read_end = buffer_base + static_cast<int64_t>(buffer.size());
+			if (read_end >= snapshot_end) {
+				eof = true;
+				return;
+			}
+			request = MinValue(request, static_cast<idx_t>(snapshot_end - read_end));
+		}
+		// Read straight into the buffer's tail
+		auto start = buffer.size();
+		buffer.resize(start + request);
+		int64_t bytes_read = source ? static_cast<int64_t>(source->Read(&buffer[start], request))
+		                            : file->Read(&buffer[start], request);
+		buffer.resize(start + static_cast<idx_t>(MaxValue<int64_t>(bytes_read, 0)));
+		if (bytes_read <= 0) {
+			eof = true;
+			return;
+		}
+		auto received = static_cast<idx_t>(bytes_read);
+		if (received == read_size) {
+			read_size = MinValue(read_size * 2, MAX_READ_SIZE);
+		} else if (received < read_size / 4) {
+			read_size = MaxValue(read_size / 2, MIN_READ_SIZE);
+		}
+	}
+
+	FileHandle *file = nullptr;
+	LineSource *source = nullptr;
+	string buffer;
+	idx_t pos = 0;
+	idx_t scan_pos = 0; // Where the search for the current line's end resumes
+	int64_t buffer_base = 0;
+	idx_t read_size = MIN_READ_SIZE;
+	bool eof = false;
+	bool bom_checked = false;
+	int64_t snapshot_end = -1;
+	bool complete_lines = false;
+};
+
+} // namespace duckdb
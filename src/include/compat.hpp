@@ -4,6 +4,7 @@
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/common/enums/file_glob_options.hpp"
 #include "duckdb/common/open_file_info.hpp"
+#include "duckdb/common/types/timestamp.hpp"
 
 namespace duckdb {
 
@@ -45,6 +46,25 @@ GlobFilesCompat(FS &fs, const string &path, ClientContext &context, FileGlobOpti
 	return fs.GlobFiles(path, context, FileGlobInput(options));
 }
 
+// FileSystem::GetLastModifiedTime returns time_t in older DuckDB and
+// timestamp_t in newer; either reduces to an opaque value for change detection.
+inline int64_t LastModifiedValue(time_t value) {
+	return static_cast<int64_t>(value);
+}
+
+inline int64_t LastModifiedValue(timestamp_t value) {
+	return value.value;
+}
+
+// The same modification time as a timestamp, for output.
+inline timestamp_t LastModifiedTimestamp(time_t value) {
+	return Timestamp::FromEpochSeconds(static_cast<int64_t>(value));
+}
+
+inline timestamp_t LastModifiedTimestamp(timestamp_t value) {
+	return value;
+}
+
 } // namespace compat
 
 } // namespace duckdb
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "line_source.hpp"
+
+namespace duckdb {
+
+// =============================================================================
+// Archive members (defined in line_archive.cpp)
+//
+// read_lines('bundle.tar.gz/**/*.log') reads the matching members of an
+// archive in place, without extracting it. Tar archives (.tar, .tar.gz,
+// .tgz, .tar.zst) are one stream and are walked member by member, the
+// container decompressed on a read-ahead thread. Zip archives (.zip) list
+// their members in a central directory, so several members are opened and
+// inflated ahead of the scan, each on its own thread.
+// =============================================================================
+
+// Split `path` at its first archive component: "logs/b.zip/app/*.log" gives
+// archive "logs/b.zip" and member pattern "app/*.log". False when no path
+// component before the last ends in an archive extension.
+bool SplitArchivePath(const string &path, string &archive, string &member_pattern);
+
+// Whether archive member `name` matches `pattern`: '*' and '?' stay within a
+// directory, '**' crosses directories ('**/' also matches none), and
+// '[...]' is a character class.
+bool MatchArchiveMember(const string &pattern, const string &name);
+
+class LineArchive {
+public:
+	virtual ~LineArchive() {
+	}
+
+	// Open the archive at `path` (its container compression already resolved
+	// for tar). `threads` bounds how many zip members inflate ahead.
+	static unique_ptr<LineArchive> Open(FileSystem &fs, const string &path, const string &member_pattern,
+	                                    FileCompressionType compression, idx_t threads);
+
+	// The next regular member matching the pattern, in archive order, with
+	// its path inside the archive in `name`; null after the last. Opening a
+	// member ends the previous one.
+	virtual unique_ptr<LineSource> NextMember(string &name) = 0;
+};
+
+} // namespace duckdb
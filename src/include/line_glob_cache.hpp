@@ -0,0 +1,66 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/open_file_info.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <chrono>
+#include <deque>
+
+namespace duckdb {
+
+// =============================================================================
+// Glob cache (defined in line_glob_cache.cpp)
+//
+// Listing a large log tree, especially on a network file system, can take
+// longer than the scan that follows. With the read_lines_glob_cache_ttl
+// setting above zero, the files a path pattern matched are kept in the
+// database's object cache and reused by later binds for up to that long.
+// Only the paths are kept: sizes and modification times the listing reported
+// go stale, so they are read from the files when scanned. Local listings are
+// also checked against the modification times of every directory the pattern
+// expands through, so a file added or removed there is seen immediately;
+// remote listings are reused for the full TTL.
+// =============================================================================
+
+static constexpr const char *GLOB_CACHE_TTL_SETTING = "read_lines_glob_cache_ttl";
+
+// GlobFiles(pattern) with ALLOW_EMPTY, served from the cache when allowed.
+vector<OpenFileInfo> GlobLineFiles(ClientContext &context, FileSystem &fs, const string &pattern);
+
+class LineGlobCache : public ObjectCacheEntry {
+public:
+	// The cache of the database `context` runs against
+	static shared_ptr<LineGlobCache> Get(ClientContext &context);
+
+	static string ObjectType() {
+		return "read_lines_glob_cache";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+	optional_idx GetEstimatedCacheMemory() const override;
+
+	// The cached files of `pattern` if listed less than `ttl_us` ago and, for
+	// local paths, none of the directories the listing read has changed.
+	bool Lookup(FileSystem &fs, const string &pattern, int64_t ttl_us, vector<OpenFileInfo> &result);
+	// Remember a listing that started at `listed_at` (wall clock seconds).
+	void Store(FileSystem &fs, const string &pattern, const vector<OpenFileInfo> &files, int64_t listed_at);
+
+private:
+	static constexpr idx_t MAX_ENTRIES = 256;
+
+	struct Entry {
+		vector<OpenFileInfo> files;
+		std::chrono::steady_clock::time_point stored;
+		// Local listings: each directory the glob read, with its
+		// modification time when listed
+		vector<std::pair<string, int64_t>> directories;
+	};
+
+	mutable mutex lock;
+	unordered_map<string, Entry> entries;
+	std::deque<string> insertion_order; // Oldest first, for eviction
+};
+
+} // namespace duckdb
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/function/scalar/strftime_format.hpp"
+#include <deque>
+
+namespace duckdb {
+
+// =============================================================================
+// Line index (defined in line_index.cpp)
+//
+// A per-file summary of where lines fall, in blocks of roughly BLOCK_SIZE
+// bytes cut at line boundaries, optionally with a bloom filter over each
+// block's byte trigrams and the range of the line timestamps it holds (a zone
+// map for time predicates). Indexes live in a process-wide cache keyed by path
+// and are only served while the file's size and modification time still
+// match the ones recorded at build time, and its first and last CHECK_BYTES
+// still hash the same, so a file rewritten in place within the timestamp's
+// resolution is not read through a stale index either. A file that has only been appended to since is not
+// re-indexed from scratch: its index is extended from the start of its last
+// block.
+// =============================================================================
+
+// What a cached index is validated against.
+struct FileIdentity {
+	int64_t size = -1;
+	int64_t last_modified = 0;
+	// last_modified in whole seconds, and the wall clock second the identity
+	// was taken in; not compared (see LineIndex::IsSettled)
+	int64_t modified_second = 0;
+	int64_t taken_at = 0;
+
+	bool operator==(const FileIdentity &other) const {
+		return size == other.size && last_modified == other.last_modified;
+	}
+	bool operator!=(const FileIdentity &other) const {
+		return !(*this == other);
+	}
+};
+
+// Reads the timestamp at the start of a line with a strptime format. The
+// format's whitespace-separated fields are matched against as many leading
+// fields of the line, so '%Y-%m-%d %H:%M:%S' parses the first two and ignores
+// the rest of the line.
+class LineTimestampParser {
+public:
+	static constexpr const char *DEFAULT_FORMAT = "%Y-%m-%d %H:%M:%S";
+
+	// Throws InvalidInputException for an invalid format.
+	explicit LineTimestampParser(string format);
+
+	const string &Format() const {
+		return format_string;
+	}
+
+	// False when the line does not start with a timestamp in this format.
+	bool Parse(const char *data, idx_t size, timestamp_t &result) const;
+
+private:
+	string format_string;
+	StrpTimeFormat format;
+	idx_t field_count;
+};
+
+// Size and modification time of an open file. Returns false for sources that
+// have neither (pipes, streams), which are never indexed.
+bool GetFileIdentity(FileHandle &handle, FileIdentity &result);
+
+struct LineIndexBlock {
+	int64_t byte_start = 0; // Offset of the block's first line
+	int64_t first_line = 1; // Line number of that line
+	int64_t line_count = 0;
+	// Bloom filter over every byte trigram of the block's lines (BLOOM_BITS
+	// bits); empty when the index was built without trigrams.
+	vector<uint64_t> trigram_bloom;
+	// Range of the block's parsed line timestamps; has_time is false when the
+	// index has no timestamps or no line of the block parsed.
+	bool has_time = false;
+	timestamp_t min_time;
+	timestamp_t max_time;
+};
+
+class LineIndex {
+public:
+	static constexpr idx_t BLOCK_SIZE = 1 << 20;
+	static constexpr idx_t BLOOM_BITS = 1 << 17;
+	// Bytes hashed at each end of the index's stable prefix (prefix_hash)
+	static constexpr idx_t CHECK_BYTES = 4096;
+
+	string path;
+	FileIdentity identity;
+	vector<LineIndexBlock> blocks;
+	int64_t total_lines = 0;
+	bool has_trigrams = false;
+	string timestamp_format; // Empty unless built with timestamps
+	// Hash of the first and last CHECK_BYTES before the last block: the part
+	// of the file an extension keeps, checked to still be there
+	hash_t prefix_hash = 0;
+	// Hash of the first and last CHECK_BYTES of the whole indexed file
+	hash_t content_hash = 0;
+
+	bool HasTrigrams() const {
+		return has_trigrams;
+	}
+	bool HasTimestamps(const string &format) const {
+		return !timestamp_format.empty() && timestamp_format == format;
+	}
+
+	// False only when no line of `block` can contain every token: each token
+	// of 3+ bytes must have all of its trigrams in the block's bloom filter.
+	bool BlockMayContain(idx_t block, const vector<string> &tokens) const;
+	// False only when no line of `block` has a timestamp within [lower, upper].
+	bool BlockMayOverlap(idx_t block, timestamp_t lower, timestamp_t upper) const;
+	// Whether this index describes `handle`, version `identity`: same size and
+	// modification time, and content_hash still matches.
+	bool IsCurrent(FileHandle &handle, const FileIdentity &identity) const;
+	// Whether the file was last modified in a second before the index read
+	// it. Otherwise it may have been rewritten within that second, keeping
+	// its size and time, and only the sampled content_hash would tell.
+	bool IsSettled() const {
+		return identity.modified_second < identity.taken_at;
+	}
+
+	// Scan `handle` (positioned at the start of the file) and build its index;
+	// `timestamps` may be null.
+	static shared_ptr<LineIndex> Build(const string &path, FileHandle &handle, const FileIdentity &identity,
+	                                   bool trigrams, const LineTimestampParser *timestamps);
+	// Index version `identity` of a file `previous` indexed at an earlier
+	// size, re-reading only from the start of its last block. Null when the
+	// file did not grow (a rewrite at the same size is no append) or the bytes
+	// before that block no longer hash the same (rotated or rewritten).
+	static shared_ptr<LineIndex> Extend(const LineIndex &previous, FileHandle &handle, const FileIdentity &identity);
+
+	// Building an index in parts, on several threads. NextLineStart is the
+	// first line start at or after `offset` (`size` if none); cutting a file
+	// at NextLineStart of evenly spaced offsets gives ranges that IndexPart
+	// indexes independently, numbering lines from 1, and Assemble joins the
+	// parts in file order, renumbering them. No trigrams or timestamps.
+	static int64_t NextLineStart(FileHandle &handle, int64_t offset, int64_t size);
+	static vector<LineIndexBlock> IndexPart(FileHandle &handle, int64_t start, int64_t end);
+	static shared_ptr<LineIndex> Assemble(const string &path, FileHandle &handle, const FileIdentity &identity,
+	                                      vector<vector<LineIndexBlock>> parts);
+
+	// The index of `path` at version `identity`, `handle` being open on it:
+	// cached, from its sidecar, or extended from a cached or sidecar index of
+	// an earlier version. Null when there is none; `handle` is left at the
+	// start of the file. With `settled_only`, an index of version `identity`
+	// that is not IsSettled() is not used either.
+	static shared_ptr<LineIndex> Find(FileSystem &fs, const string &path, FileHandle &handle,
+	                                  const FileIdentity &identity, bool settled_only = false);
+
+	// Optional on-disk copy next to the indexed file (`<path>.lines.idx`), so
+	// the index outlives the process. Find reads it through ReadSidecar.
+	static string SidecarPath(const string &path);
+	void WriteSidecar(FileSystem &fs) const;
+
+private:
+	// Offset of the last block: where an extension resumes
+	int64_t StableEnd() const {
+		return blocks.empty() ? 0 : blocks.back().byte_start;
+	}
+	static shared_ptr<LineIndex> ReadSidecar(FileSystem &fs, const string &path);
+	int64_t IndexLines(FileHandle &handle, int64_t start_offset, int64_t end_offset, int64_t first_line,
+	                   const LineTimestampParser *timestamps);
+};
+
+class LineIndexCache {
+public:
+	static LineIndexCache &Get();
+
+	// The cached index of `path`, whatever file version it was built for;
+	// LineIndex::IsCurrent tells whether it still describes the file.
+	shared_ptr<LineIndex> Lookup(const string &path);
+	void Store(shared_ptr<LineIndex> index);
+
+private:
+	static constexpr idx_t MAX_ENTRIES = 4096;
+
+	mutex lock;
+	unordered_map<string, shared_ptr<LineIndex>> entries;
+	std::deque<string> insertion_order; // Oldest first, for eviction
+};
+
+} // namespace duckdb
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// =============================================================================
+// LineMatcher (defined in line_matcher.cpp)
+//
+// Literal (grep -F style) matching for read_lines' `match` / `match_any`
+// options, applied to each line's bytes in the reader buffer before anything
+// is materialized. Lines are matched without their terminator.
+//
+// A single pattern is found with memchr + memcmp. Several patterns are
+// compiled into one Aho-Corasick automaton (a DFA over byte classes), so a
+// line is scanned once however many patterns there are.
+// =============================================================================
+class LineMatcher {
+public:
+	// Throws InvalidInputException when there are no patterns or one is empty.
+	explicit LineMatcher(vector<string> patterns);
+
+	// True when the line contains a pattern. pattern_id is then the 0-based
+	// index of the first pattern found scanning left to right (the one that
+	// ends first; the lowest index when several end at the same byte).
+	bool Match(const char *data, idx_t size, idx_t &pattern_id) const;
+
+	bool Matches(const char *data, idx_t size) const {
+		idx_t pattern_id;
+		return Match(data, size, pattern_id);
+	}
+
+private:
+	static constexpr int32_t NO_MATCH = -1;
+
+	bool MatchSingle(const char *data, idx_t begin, idx_t end) const;
+	bool MatchAutomaton(const char *data, idx_t begin, idx_t end, idx_t &pattern_id) const;
+	void BuildAutomaton();
+
+	vector<string> patterns;
+	// Automaton: bytes that occur in no pattern share class 0
+	uint16_t byte_class[256];
+	idx_t class_count = 0;
+	vector<uint32_t> transitions; // state * class_count + class -> state
+	vector<int32_t> state_match;  // Lowest pattern index ending at a state, or NO_MATCH
+	// Bytes that leave the root state where it is (no pattern starts with
+	// them): skipped without a table lookup while no partial match is open
+	bool root_skip[256];
+};
+
+} // namespace duckdb
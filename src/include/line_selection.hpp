@@ -53,6 +53,9 @@ public:
 	// Expand ranges to include context lines
 	void AddContext(int64_t before, int64_t after);
 
+	// The lines any of `selections` selects
+	static LineSelection Union(const vector<LineSelection> &selections);
+
 private:
 	LineSelection() : match_all_(true) {
 	}
@@ -66,6 +69,12 @@ private:
 
 	// Parse a single range string like "100-200" or "13 -2 +3" (with per-entry context)
 	static LineRange ParseRangeString(const string &str);
+	// ParseRangeString through a process-wide cache of spec strings, which
+	// remembers invalid specs too; false (without the error) for those.
+	// Statements re-bound with the same window skip the parser.
+	static bool TryParseRangeStringCached(const string &str, LineRange &result);
+	// The cached parse of a spec the user gave; throws if it is invalid
+	static LineRange ParseRangeSpec(const string &str);
 
 public:
 	// Parse a path that may contain an embedded line spec (e.g., "file.py:13-14")
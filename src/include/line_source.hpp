@@ -0,0 +1,170 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/file_compression_type.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <thread>
+
+namespace duckdb {
+
+// =============================================================================
+// Line sources (defined in line_source.cpp)
+//
+// BufferedLineReader reads a FileHandle directly, or a LineSource when the
+// bytes need work before they can be split into lines. Decompressing
+// sources inflate on a background thread, ahead of the splitter, so inflation
+// and line splitting / row writing overlap instead of taking turns on one
+// core.
+// =============================================================================
+
+class AbandonedReaders;
+
+class LineSource {
+public:
+	virtual ~LineSource() {
+	}
+	// Up to `size` bytes of the stream; 0 at end of stream.
+	virtual idx_t Read(char *buffer, idx_t size) = 0;
+	// Wait until Read() would return without blocking, or until `deadline`;
+	// false on timeout. Sources that never wait on a producer are always ready.
+	virtual bool WaitReady(std::chrono::steady_clock::time_point deadline) {
+		return true;
+	}
+	// The scan is done with this source and with `handle`, the file it reads:
+	// a source whose thread may be blocked on the handle stops without waiting
+	// for it, hands the thread to `owner`, and closes the handle from that
+	// thread once the read returns. Other sources leave `handle` to the caller.
+	virtual void Abandon(unique_ptr<FileHandle> &handle, AbandonedReaders &owner) {
+	}
+};
+
+// The read-ahead threads a database's scans abandoned, kept in its object
+// cache. Each ends once its blocked read returns; those still running when
+// the database shuts down are joined then, before its file systems go away,
+// so shutdown waits for their commands to write or exit.
+class AbandonedReaders : public ObjectCacheEntry {
+public:
+	~AbandonedReaders() override;
+
+	static shared_ptr<AbandonedReaders> Get(ClientContext &context);
+
+	static string ObjectType() {
+		return "read_lines_abandoned_readers";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+	// Threads, not cached data: never worth evicting
+	optional_idx GetEstimatedCacheMemory() const override {
+		return optional_idx();
+	}
+
+	// Take over `thread`, which sets `exited` as it ends; joins the threads
+	// taken over before that have ended since.
+	void Add(std::thread thread, shared_ptr<std::atomic<bool>> exited);
+
+private:
+	struct Reader {
+		std::thread thread;
+		shared_ptr<std::atomic<bool>> exited;
+	};
+
+	mutex lock;
+	vector<Reader> readers;
+};
+
+// Produces the decompressed stream in chunks, on ReadAheadSource's thread.
+class ChunkProducer {
+public:
+	virtual ~ChunkProducer() {
+	}
+	// Replace `chunk` with the next piece of the stream; false at its end.
+	virtual bool Next(string &chunk) = 0;
+};
+
+// Lets one consumer wait until any of several ReadAheadSources has output.
+class ReadySignal {
+public:
+	// Read before checking the sources; Wait() returns once any of them
+	// changed state after that.
+	idx_t Generation();
+	void Wait(idx_t seen);
+	void Notify();
+
+private:
+	mutex lock;
+	std::condition_variable changed;
+	idx_t generation = 0;
+};
+
+// Runs a ChunkProducer on a background thread, keeping up to
+// MAX_QUEUED_BYTES of its output ready for Read(). Producer errors are
+// rethrown from Read(). Read() hands out as many queued chunks as fit, and
+// briefly waits for more while it has less than MIN_BATCH, so a trickle of
+// small chunks reaches the line splitter as fewer, larger reads.
+class ReadAheadSource : public LineSource {
+public:
+	explicit ReadAheadSource(unique_ptr<ChunkProducer> producer, shared_ptr<ReadySignal> signal = nullptr);
+	~ReadAheadSource() override;
+
+	idx_t Read(char *buffer, idx_t size) override;
+	// Whether Read() would return without waiting (output, end or error)
+	bool Ready();
+	bool WaitReady(std::chrono::steady_clock::time_point deadline) override;
+	// Hand the thread to `owner` rather than join it: a quiet command
+	// ('tail -f') may not write again for a long time, and closing its pipe
+	// waits for it
+	void Abandon(unique_ptr<FileHandle> &handle, AbandonedReaders &owner) override;
+
+private:
+	static constexpr idx_t MAX_QUEUED_BYTES = 8 << 20;
+	static constexpr idx_t MIN_BATCH = 64 << 10;
+	static constexpr int64_t COALESCE_DELAY_US = 2000;
+
+	// What the thread uses, kept alive by it after Abandon()
+	struct Shared {
+		unique_ptr<ChunkProducer> producer;
+		shared_ptr<ReadySignal> signal; // Notified as output arrives, if set
+		mutex lock;
+		std::condition_variable produced; // Signals Read(): data, end or error
+		std::condition_variable consumed; // Signals Run(): room in the queue, or stop
+		std::deque<string> chunks;
+		idx_t queued_bytes = 0;
+		bool finished = false;
+		bool stopping = false;
+		std::exception_ptr error;
+		unique_ptr<FileHandle> abandoned_handle; // Closed when the thread ends
+		shared_ptr<std::atomic<bool>> exited;   // Set once the thread is done with everything
+	};
+
+	static void Run(Shared &shared);
+	void Stop();
+
+	shared_ptr<Shared> shared;
+	string current; // Chunk being handed out by Read()
+	idx_t current_pos = 0;
+	std::thread thread;
+};
+
+// Read `handle` as is on a read-ahead thread. For pipes ('cmd |' on shellfs),
+// so several commands can run and fill their queues while one is scanned.
+unique_ptr<ReadAheadSource> OpenReadAheadSource(FileHandle &handle, shared_ptr<ReadySignal> signal);
+
+// The compression a `compression` option value means for `path`: AUTO_DETECT
+// is resolved from the extension (.gz / .gzip / .tgz, .zst), anything else is
+// kept.
+FileCompressionType ResolveLineCompression(FileCompressionType requested, const string &path);
+
+// Open `path` as a decompressing line source, or return null when it is not
+// compressed (`compression` already resolved). `threads` bounds the parallel
+// inflation of BGZF (blocked multi-member) gzip files.
+unique_ptr<LineSource> OpenDecompressingSource(FileSystem &fs, const string &path, FileCompressionType compression,
+                                               idx_t threads, unique_ptr<FileHandle> &handle);
+
+} // namespace duckdb
@@ -33,6 +33,11 @@ int64_t CountLinesInText(const string &text, idx_t start = 0);
 // line content (with the terminator preserved). Returns "" when at the end.
 string ExtractLine(const string &text, idx_t &position);
 
+// Position just past the line starting at `position` in `text[0, size)`: after
+// its terminator, or `size` for a final unterminated line. The non-allocating
+// core of ExtractLine, for readers that hand out views into their buffer.
+idx_t FindLineEnd(const char *text, idx_t size, idx_t position);
+
 // =============================================================================
 // Content trimming (the `trim` argument of read_lines / read_lines_lateral /
 // parse_lines). A pure content transform applied after splitting: line
@@ -55,4 +60,33 @@ LineTrimMode ParseLineTrimMode(const Value &value);
 // Apply a trim mode to one split line (whose content includes its terminator).
 string ApplyLineTrim(const string &line, LineTrimMode mode);
 
+// The same transform without materializing: narrows [begin, end) of a line's
+// bytes to the trimmed content.
+void LineTrimBounds(const char *data, LineTrimMode mode, idx_t &begin, idx_t &end);
+
+// =============================================================================
+// Field splitting (the `split` argument of read_lines / parse_lines). Fields
+// are cut from the trimmed content straight into a VARCHAR[] output vector,
+// without building the content string first. The terminator never lands in
+// the last field, whatever the trim mode; otherwise the result matches
+// string_split(content, delimiter).
+// =============================================================================
+
+// Validate a split argument; returns false for NULL (no `fields` column).
+bool ParseSplitDelimiter(const Value &value, string &delimiter);
+
+// Split one line and write it as list entry `row` of a VARCHAR[] vector.
+void AppendLineFields(Vector &list_vector, idx_t row, const char *data, idx_t size, LineTrimMode mode,
+                      const string &delimiter);
+
+// =============================================================================
+// Log templates (the `template` argument of read_lines; defined in
+// line_template.cpp). Masks the variable parts of a line in a single pass:
+// quoted strings -> <STR>, UUIDs -> <UUID>, 0x-prefixed and long mixed hex ids
+// -> <HEX>, numbers (including dotted forms like 10.0.0.1) -> <NUM>.
+// =============================================================================
+
+// Build the template of one line's (terminator-free) content into `result`.
+void BuildLineTemplate(const char *data, idx_t size, string &result);
+
 } // namespace duckdb
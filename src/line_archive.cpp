@@ -0,0 +1,628 @@
+#include "line_archive.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <cstring>
+#include <zlib.h>
+
+namespace duckdb {
+
+// =============================================================================
+// Paths and member patterns
+// =============================================================================
+
+static bool IsArchiveName(const string &name) {
+	auto lower = StringUtil::Lower(name);
+	for (auto extension : {".zip", ".tar", ".tar.gz", ".tgz", ".tar.zst"}) {
+		if (StringUtil::EndsWith(lower, extension)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool SplitArchivePath(const string &path, string &archive, string &member_pattern) {
+	for (auto slash = path.find('/'); slash != string::npos; slash = path.find('/', slash + 1)) {
+		if (slash > 0 && IsArchiveName(path.substr(0, slash))) {
+			archive = path.substr(0, slash);
+			member_pattern = path.substr(slash + 1);
+			if (member_pattern.empty()) {
+				member_pattern = "**";
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+// Match `[...]` at `p` against `c`; advances `p` past the class.
+static bool MatchClass(const char *&p, const char *pend, char c) {
+	auto start = p;
+	p++;
+	bool negate = p < pend && (*p == '!' || *p == '^');
+	if (negate) {
+		p++;
+	}
+	bool matched = false;
+	bool first = true;
+	while (p < pend && (*p != ']' || first)) {
+		if (p + 2 < pend && p[1] == '-' && p[2] != ']') {
+			matched |= c >= p[0] && c <= p[2];
+			p += 3;
+		} else {
+			matched |= c == *p;
+			p++;
+		}
+		first = false;
+	}
+	if (p == pend) {
+		// No closing bracket: a literal '['
+		p = start + 1;
+		return c == '[';
+	}
+	p++;
+	return matched != negate && c != '/';
+}
+
+static bool MatchGlob(const char *p, const char *pend, const char *s, const char *send) {
+	while (p < pend) {
+		if (*p == '*') {
+			if (p + 1 < pend && p[1] == '*') {
+				p += 2;
+				if (p < pend && *p == '/' && MatchGlob(p + 1, pend, s, send)) {
+					return true;
+				}
+				for (auto t = s; t <= send; t++) {
+					if (MatchGlob(p, pend, t, send)) {
+						return true;
+					}
+				}
+				return false;
+			}
+			p++;
+			for (auto t = s;; t++) {
+				if (MatchGlob(p, pend, t, send)) {
+					return true;
+				}
+				if (t == send || *t == '/') {
+					return false;
+				}
+			}
+		}
+		if (s == send) {
+			return false;
+		}
+		if (*p == '[') {
+			if (!MatchClass(p, pend, *s)) {
+				return false;
+			}
+			s++;
+			continue;
+		}
+		if (*p == '?' ? *s == '/' : *p != *s) {
+			return false;
+		}
+		p++;
+		s++;
+	}
+	return s == send;
+}
+
+bool MatchArchiveMember(const string &pattern, const string &name) {
+	return MatchGlob(pattern.data(), pattern.data() + pattern.size(), name.data(), name.data() + name.size());
+}
+
+// Member names as the archive stores them, minus a leading "./"
+static string NormalizeMemberName(string name) {
+	while (StringUtil::StartsWith(name, "./")) {
+		name = name.substr(2);
+	}
+	return name;
+}
+
+// =============================================================================
+// Tar
+// =============================================================================
+
+// Reads an uncompressed container straight from its handle.
+class HandleLineSource : public LineSource {
+public:
+	explicit HandleLineSource(FileHandle &handle) : handle(handle) {
+	}
+
+	idx_t Read(char *buffer, idx_t size) override {
+		auto bytes_read = handle.Read(buffer, size);
+		return static_cast<idx_t>(MaxValue<int64_t>(bytes_read, 0));
+	}
+
+private:
+	FileHandle &handle;
+};
+
+class TarArchive;
+
+// The data of the current tar member, read from the archive stream.
+class TarMemberSource : public LineSource {
+public:
+	explicit TarMemberSource(TarArchive &archive) : archive(archive) {
+	}
+
+	idx_t Read(char *buffer, idx_t size) override;
+
+private:
+	TarArchive &archive;
+};
+
+class TarArchive : public LineArchive {
+public:
+	TarArchive(FileSystem &fs, const string &path_p, const string &member_pattern_p, FileCompressionType compression,
+	           idx_t threads)
+	    : path(path_p), member_pattern(member_pattern_p) {
+		stream = OpenDecompressingSource(fs, path, compression, threads, handle);
+		if (!stream) {
+			handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+			stream = make_uniq<HandleLineSource>(*handle);
+		}
+	}
+
+	unique_ptr<LineSource> NextMember(string &name) override {
+		// Skip whatever the scan left of the previous member
+		Skip(member_remaining + member_padding);
+		member_remaining = 0;
+		member_padding = 0;
+
+		string long_name;
+		uint8_t header[BLOCK_SIZE];
+		while (!finished) {
+			auto header_size = ReadFully(reinterpret_cast<char *>(header), BLOCK_SIZE);
+			if (header_size == 0 || (header_size == BLOCK_SIZE && IsZeroBlock(header))) {
+				// End of the stream, or the end-of-archive marker
+				finished = true;
+				break;
+			}
+			if (header_size < BLOCK_SIZE || !ValidChecksum(header)) {
+				throw IOException("read_lines: \"%s\" is not a valid tar archive", path);
+			}
+			auto size = ParseNumber(header + 124, 12);
+			auto padding = (BLOCK_SIZE - size % BLOCK_SIZE) % BLOCK_SIZE;
+			auto type = header[156];
+
+			if (type == 'L' || type == 'x') {
+				// GNU long name / pax extended header for the next member. Its
+				// size comes from the header: bound it before allocating
+				if (size > MAX_EXTENDED_HEADER) {
+					throw IOException("read_lines: \"%s\" is not a valid tar archive", path);
+				}
+				string data(size, '\0');
+				if (ReadFully(&data[0], size) < size) {
+					break;
+				}
+				Skip(padding);
+				if (type == 'L') {
+					long_name = data.substr(0, strnlen(data.c_str(), data.size()));
+				} else {
+					ParsePaxPath(data, long_name);
+				}
+				continue;
+			}
+
+			string member_name = long_name.empty() ? HeaderName(header) : long_name;
+			long_name.clear();
+			member_name = NormalizeMemberName(member_name);
+			bool regular = type == '0' || type == '\0' || type == '7';
+			if (!regular || !MatchArchiveMember(member_pattern, member_name)) {
+				Skip(size + padding);
+				continue;
+			}
+			member_remaining = size;
+			member_padding = padding;
+			name = std::move(member_name);
+			return make_uniq<TarMemberSource>(*this);
+		}
+		return nullptr;
+	}
+
+	idx_t ReadMember(char *buffer, idx_t size) {
+		auto bytes_read = ReadFully(buffer, MinValue<idx_t>(size, member_remaining));
+		member_remaining -= bytes_read;
+		return bytes_read;
+	}
+
+private:
+	static constexpr idx_t BLOCK_SIZE = 512;
+	// Largest long name or pax record accepted; real ones are a few hundred bytes
+	static constexpr idx_t MAX_EXTENDED_HEADER = 1 << 20;
+
+	idx_t ReadFully(char *buffer, idx_t size) {
+		idx_t total = 0;
+		while (total < size) {
+			auto bytes_read = stream->Read(buffer + total, size - total);
+			if (bytes_read == 0) {
+				break;
+			}
+			total += bytes_read;
+		}
+		return total;
+	}
+
+	void Skip(idx_t size) {
+		char buffer[64 << 10];
+		while (size > 0) {
+			auto bytes_read = ReadFully(buffer, MinValue<idx_t>(size, sizeof(buffer)));
+			if (bytes_read == 0) {
+				return;
+			}
+			size -= bytes_read;
+		}
+	}
+
+	static bool IsZeroBlock(const uint8_t *header) {
+		for (idx_t i = 0; i < BLOCK_SIZE; i++) {
+			if (header[i] != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Octal, space/NUL padded; or GNU base-256 when the high bit is set
+	static idx_t ParseNumber(const uint8_t *field, idx_t size) {
+		idx_t value = 0;
+		if (field[0] & 0x80) {
+			value = field[0] & 0x7f;
+			for (idx_t i = 1; i < size; i++) {
+				value = (value << 8) | field[i];
+			}
+			return value;
+		}
+		idx_t i = 0;
+		while (i < size && field[i] == ' ') {
+			i++;
+		}
+		for (; i < size && field[i] >= '0' && field[i] <= '7'; i++) {
+			value = value * 8 + (field[i] - '0');
+		}
+		return value;
+	}
+
+	static bool ValidChecksum(const uint8_t *header) {
+		idx_t sum = 0;
+		for (idx_t i = 0; i < BLOCK_SIZE; i++) {
+			sum += (i >= 148 && i < 156) ? ' ' : header[i];
+		}
+		return sum == ParseNumber(header + 148, 8);
+	}
+
+	// name, with the ustar prefix in front when there is one
+	static string HeaderName(const uint8_t *header) {
+		auto field = reinterpret_cast<const char *>(header);
+		string name(field, strnlen(field, 100));
+		if (memcmp(header + 257, "ustar", 5) == 0 && header[345] != 0) {
+			name = string(field + 345, strnlen(field + 345, 155)) + "/" + name;
+		}
+		return name;
+	}
+
+	// pax records are "<length> <key>=<value>\n"
+	static void ParsePaxPath(const string &data, string &name) {
+		idx_t pos = 0;
+		while (pos < data.size()) {
+			auto space = data.find(' ', pos);
+			if (space == string::npos) {
+				return;
+			}
+			auto length = static_cast<idx_t>(std::strtoull(data.c_str() + pos, nullptr, 10));
+			if (length == 0 || pos + length > data.size()) {
+				return;
+			}
+			auto record = data.substr(space + 1, pos + length - space - 2);
+			if (StringUtil::StartsWith(record, "path=")) {
+				name = record.substr(5);
+			}
+			pos += length;
+		}
+	}
+
+	string path;
+	string member_pattern;
+	unique_ptr<FileHandle> handle;
+	unique_ptr<LineSource> stream; // The decompressed container
+	idx_t member_remaining = 0;    // Unread data bytes of the current member
+	idx_t member_padding = 0;      // Padding after them, to the next header
+	bool finished = false;
+};
+
+idx_t TarMemberSource::Read(char *buffer, idx_t size) {
+	return archive.ReadMember(buffer, size);
+}
+
+// =============================================================================
+// Zip
+// =============================================================================
+
+static uint16_t Load16(const uint8_t *data) {
+	return static_cast<uint16_t>(data[0] | data[1] << 8);
+}
+
+static uint32_t Load32(const uint8_t *data) {
+	return uint32_t(data[0]) | uint32_t(data[1]) << 8 | uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24;
+}
+
+static uint64_t Load64(const uint8_t *data) {
+	return uint64_t(Load32(data)) | uint64_t(Load32(data + 4)) << 32;
+}
+
+struct ZipEntry {
+	string name;
+	uint16_t method;
+	uint32_t crc;
+	idx_t compressed_size;
+	idx_t uncompressed_size;
+	idx_t local_header_offset;
+	bool encrypted = false;
+};
+
+// Stands in for a zip member that could not be opened: reading it raises the
+// error, so the scan reports that member and goes on to the next.
+class FailedChunkProducer : public ChunkProducer {
+public:
+	explicit FailedChunkProducer(std::exception_ptr error) : error(std::move(error)) {
+	}
+
+	bool Next(string &chunk) override {
+		std::rethrow_exception(error);
+	}
+
+private:
+	std::exception_ptr error;
+};
+
+// Inflates (or copies, when stored) one zip member from its own handle, on
+// a ReadAheadSource thread.
+class ZipMemberProducer : public ChunkProducer {
+public:
+	ZipMemberProducer(FileSystem &fs, const string &path_p, const ZipEntry &entry_p) : path(path_p), entry(entry_p) {
+		if (entry.encrypted) {
+			throw IOException("read_lines: zip member \"%s\" in \"%s\" is encrypted", entry.name, path);
+		}
+		if (entry.method != 0 && entry.method != 8) {
+			throw IOException("read_lines: zip member \"%s\" in \"%s\" uses unsupported compression method %d",
+			                  entry.name, path, entry.method);
+		}
+		handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+		uint8_t local[30];
+		handle->Read(local, sizeof(local), entry.local_header_offset);
+		if (Load32(local) != 0x04034b50) {
+			throw IOException("read_lines: corrupt zip archive \"%s\"", path);
+		}
+		input_offset = entry.local_header_offset + sizeof(local) + Load16(local + 26) + Load16(local + 28);
+		input_remaining = entry.compressed_size;
+		memset(&stream, 0, sizeof(stream));
+		if (entry.method == 8) {
+			if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+				throw IOException("read_lines: failed to initialize inflate for \"%s\"", path);
+			}
+			inflating = true;
+		}
+	}
+
+	~ZipMemberProducer() override {
+		if (inflating) {
+			inflateEnd(&stream);
+		}
+	}
+
+	bool Next(string &chunk) override {
+		if (done) {
+			return false;
+		}
+		if (entry.method == 0) {
+			auto size = MinValue<idx_t>(input_remaining, CHUNK_SIZE);
+			chunk.resize(size);
+			if (size > 0) {
+				handle->Read(&chunk[0], size, input_offset);
+			}
+			input_offset += size;
+			input_remaining -= size;
+			done = input_remaining == 0;
+		} else {
+			InflateChunk(chunk);
+		}
+		crc = crc32(crc, reinterpret_cast<const Bytef *>(chunk.data()), static_cast<uInt>(chunk.size()));
+		output_size += chunk.size();
+		if (done && (crc != entry.crc || output_size != entry.uncompressed_size)) {
+			throw IOException("read_lines: corrupt zip member \"%s\" in \"%s\"", entry.name, path);
+		}
+		return !chunk.empty() || !done;
+	}
+
+private:
+	static constexpr idx_t CHUNK_SIZE = 1 << 20;
+	static constexpr idx_t INPUT_SIZE = 256 << 10;
+
+	void InflateChunk(string &chunk) {
+		chunk.resize(CHUNK_SIZE);
+		stream.next_out = reinterpret_cast<Bytef *>(&chunk[0]);
+		stream.avail_out = static_cast<uInt>(CHUNK_SIZE);
+		while (stream.avail_out > 0) {
+			if (stream.avail_in == 0 && input_remaining > 0) {
+				auto size = MinValue<idx_t>(input_remaining, INPUT_SIZE);
+				input.resize(size);
+				handle->Read(&input[0], size, input_offset);
+				input_offset += size;
+				input_remaining -= size;
+				stream.next_in = reinterpret_cast<Bytef *>(&input[0]);
+				stream.avail_in = static_cast<uInt>(size);
+			}
+			auto result = inflate(&stream, Z_NO_FLUSH);
+			if (result == Z_STREAM_END) {
+				done = true;
+				break;
+			}
+			if (result != Z_OK) {
+				throw IOException("read_lines: corrupt zip member \"%s\" in \"%s\"", entry.name, path);
+			}
+		}
+		chunk.resize(CHUNK_SIZE - stream.avail_out);
+	}
+
+	string path;
+	ZipEntry entry;
+	unique_ptr<FileHandle> handle;
+	z_stream stream;
+	bool inflating = false;
+	string input;
+	idx_t input_offset;
+	idx_t input_remaining;
+	uint32_t crc = 0;
+	idx_t output_size = 0;
+	bool done = false;
+};
+
+class ZipArchive : public LineArchive {
+public:
+	ZipArchive(FileSystem &fs_p, const string &path_p, const string &member_pattern, idx_t threads)
+	    : fs(fs_p), path(path_p), max_open(MinValue<idx_t>(MaxValue<idx_t>(threads, 1), MAX_OPEN_MEMBERS)) {
+		auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+		for (auto &entry : ReadCentralDirectory(*handle)) {
+			if (!StringUtil::EndsWith(entry.name, "/") && MatchArchiveMember(member_pattern, entry.name)) {
+				entries.push_back(std::move(entry));
+			}
+		}
+	}
+
+	unique_ptr<LineSource> NextMember(string &name) override {
+		// Keep up to max_open members inflating ahead of the scan
+		while (open.size() < max_open && next_entry < entries.size()) {
+			auto &entry = entries[next_entry++];
+			unique_ptr<ChunkProducer> producer;
+			try {
+				producer = make_uniq<ZipMemberProducer>(fs, path, entry);
+			} catch (std::exception &) {
+				// Only this member is unreadable
+				producer = make_uniq<FailedChunkProducer>(std::current_exception());
+			}
+			auto source = make_uniq<ReadAheadSource>(std::move(producer));
+			open.emplace_back(entry.name, std::move(source));
+		}
+		if (open.empty()) {
+			return nullptr;
+		}
+		name = std::move(open.front().first);
+		auto source = std::move(open.front().second);
+		open.pop_front();
+		return source;
+	}
+
+private:
+	static constexpr idx_t MAX_OPEN_MEMBERS = 8;
+	static constexpr idx_t EOCD_SIZE = 22;
+
+	vector<ZipEntry> ReadCentralDirectory(FileHandle &handle) {
+		auto file_size = handle.GetFileSize();
+		// The end-of-central-directory record: last in the file, before a
+		// comment of up to 64 KiB
+		auto tail_size = MinValue<idx_t>(file_size, EOCD_SIZE + 0xFFFF);
+		string tail(tail_size, '\0');
+		handle.Read(&tail[0], tail_size, file_size - tail_size);
+		auto data = reinterpret_cast<const uint8_t *>(tail.data());
+		idx_t eocd = DConstants::INVALID_INDEX;
+		for (idx_t pos = tail_size >= EOCD_SIZE ? tail_size - EOCD_SIZE + 1 : 0; pos-- > 0;) {
+			if (Load32(data + pos) == 0x06054b50) {
+				eocd = pos;
+				break;
+			}
+		}
+		if (eocd == DConstants::INVALID_INDEX) {
+			throw IOException("read_lines: \"%s\" is not a valid zip archive", path);
+		}
+		idx_t entry_count = Load16(data + eocd + 10);
+		idx_t directory_size = Load32(data + eocd + 12);
+		idx_t directory_offset = Load32(data + eocd + 16);
+		if (eocd >= 20 && Load32(data + eocd - 20) == 0x07064b50) {
+			// Zip64: the real counts live in the zip64 end record
+			uint8_t record[56];
+			handle.Read(record, sizeof(record), Load64(data + eocd - 20 + 8));
+			if (Load32(record) != 0x06064b50) {
+				throw IOException("read_lines: corrupt zip archive \"%s\"", path);
+			}
+			entry_count = Load64(record + 32);
+			directory_size = Load64(record + 40);
+			directory_offset = Load64(record + 48);
+		}
+		if (directory_offset + directory_size > file_size) {
+			throw IOException("read_lines: corrupt zip archive \"%s\"", path);
+		}
+
+		string directory(directory_size, '\0');
+		if (directory_size > 0) {
+			handle.Read(&directory[0], directory_size, directory_offset);
+		}
+		data = reinterpret_cast<const uint8_t *>(directory.data());
+		vector<ZipEntry> result;
+		idx_t pos = 0;
+		for (idx_t i = 0; i < entry_count; i++) {
+			if (pos + 46 > directory_size || Load32(data + pos) != 0x02014b50) {
+				throw IOException("read_lines: corrupt zip archive \"%s\"", path);
+			}
+			auto name_size = Load16(data + pos + 28);
+			auto extra_size = Load16(data + pos + 30);
+			auto comment_size = Load16(data + pos + 32);
+			if (pos + 46 + name_size + extra_size + comment_size > directory_size) {
+				throw IOException("read_lines: corrupt zip archive \"%s\"", path);
+			}
+			ZipEntry entry;
+			entry.name = NormalizeMemberName(string(reinterpret_cast<const char *>(data + pos + 46), name_size));
+			entry.method = Load16(data + pos + 10);
+			entry.crc = Load32(data + pos + 16);
+			entry.compressed_size = Load32(data + pos + 20);
+			entry.uncompressed_size = Load32(data + pos + 24);
+			entry.local_header_offset = Load32(data + pos + 42);
+			ReadZip64Extra(data + pos + 46 + name_size, extra_size, entry);
+			entry.encrypted = (Load16(data + pos + 8) & 1) != 0;
+			result.push_back(std::move(entry));
+			pos += 46 + name_size + extra_size + comment_size;
+		}
+		return result;
+	}
+
+	// Sizes and offsets that overflow 32 bits are 0xFFFFFFFF, with the real
+	// values in the zip64 extra field, in this order
+	static void ReadZip64Extra(const uint8_t *extra, idx_t extra_size, ZipEntry &entry) {
+		for (idx_t pos = 0; pos + 4 <= extra_size;) {
+			auto id = Load16(extra + pos);
+			idx_t size = Load16(extra + pos + 2);
+			if (id == 0x0001) {
+				auto field = extra + pos + 4;
+				auto end = field + MinValue<idx_t>(size, extra_size - pos - 4);
+				for (auto value : {&entry.uncompressed_size, &entry.compressed_size, &entry.local_header_offset}) {
+					if (*value == 0xFFFFFFFF && field + 8 <= end) {
+						*value = Load64(field);
+						field += 8;
+					}
+				}
+				return;
+			}
+			pos += 4 + size;
+		}
+	}
+
+	FileSystem &fs;
+	string path;
+	idx_t max_open;
+	vector<ZipEntry> entries; // Matching members, in directory order
+	idx_t next_entry = 0;
+	std::deque<std::pair<string, unique_ptr<LineSource>>> open;
+};
+
+// =============================================================================
+// Opening
+// =============================================================================
+
+unique_ptr<LineArchive> LineArchive::Open(FileSystem &fs, const string &path, const string &member_pattern,
+                                          FileCompressionType compression, idx_t threads) {
+	if (StringUtil::EndsWith(StringUtil::Lower(path), ".zip")) {
+		return make_uniq<ZipArchive>(fs, path, member_pattern, threads);
+	}
+	return make_uniq<TarArchive>(fs, path, member_pattern, compression, threads);
+}
+
+} // namespace duckdb
@@ -0,0 +1,244 @@
+#include "line_glob_cache.hpp"
+#include "compat.hpp"
+#include "line_archive.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <ctime>
+#include <set>
+
+namespace duckdb {
+
+static bool IsRemotePath(const string &path) {
+	return path.find("://") != string::npos;
+}
+
+// Modification time of a local directory, in seconds; false if it is gone
+// or the file system cannot open directories to say.
+static bool DirectoryModifiedTime(FileSystem &fs, const string &directory, int64_t &result) {
+	try {
+		auto handle = fs.OpenFile(directory, FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (!handle) {
+			return false;
+		}
+		result = Timestamp::GetEpochSeconds(compat::LastModifiedTimestamp(fs.GetLastModifiedTime(*handle)));
+		return true;
+	} catch (std::exception &) {
+		return false;
+	}
+}
+
+static idx_t LastSeparator(const string &path, idx_t end) {
+	for (idx_t i = end; i > 0; i--) {
+		if (path[i - 1] == '/' || path[i - 1] == '\\') {
+			return i - 1;
+		}
+	}
+	return string::npos;
+}
+
+static void SplitComponents(const string &path, vector<string> &result) {
+	idx_t begin = 0;
+	for (idx_t i = 0; i <= path.size(); i++) {
+		if (i == path.size() || path[i] == '/' || path[i] == '\\') {
+			if (i > begin) {
+				result.push_back(path.substr(begin, i - begin));
+			}
+			begin = i + 1;
+		}
+	}
+}
+
+static void ListSubdirectories(FileSystem &fs, const string &directory, vector<string> &result) {
+	try {
+		fs.ListFiles(directory, [&](const string &name, bool is_directory) {
+			if (is_directory && name != "." && name != "..") {
+				result.push_back(name);
+			}
+		});
+	} catch (std::exception &) {
+		// Gone since the listing; the directory's own time check catches it
+	}
+}
+
+// The directories a listing of `pattern` reads: the literal directory the
+// pattern starts in and every directory its wildcard components descend
+// into, whether or not a file matched there. Walked with the glob's rules:
+// '*', '?' and '[...]' stay within a name, '**' takes every directory below.
+static std::set<string> ListedDirectories(FileSystem &fs, const string &pattern) {
+	auto wildcard = pattern.find_first_of("*?[{");
+	auto root_end = LastSeparator(pattern, wildcard == string::npos ? pattern.size() : wildcard);
+	auto root = root_end == string::npos ? string(".") : pattern.substr(0, MaxValue<idx_t>(root_end, 1));
+	std::set<string> result;
+	result.insert(root);
+	vector<string> components;
+	SplitComponents(root_end == string::npos ? pattern : pattern.substr(root_end + 1), components);
+	if (components.empty()) {
+		return result;
+	}
+	// The last component names the files, except a trailing '**'
+	auto directory_components = components.size() - (components.back() == "**" ? 0 : 1);
+	vector<string> level {root};
+	for (idx_t i = 0; i < directory_components && !level.empty(); i++) {
+		auto &component = components[i];
+		vector<string> next;
+		if (component == "**") {
+			// Zero or more directories: this level and everything below it
+			next = level;
+			for (idx_t d = 0; d < next.size(); d++) {
+				vector<string> names;
+				ListSubdirectories(fs, next[d], names);
+				for (auto &name : names) {
+					auto directory = next[d] + "/" + name;
+					if (result.insert(directory).second) {
+						next.push_back(std::move(directory));
+					}
+				}
+			}
+		} else if (!FileSystem::HasGlob(component)) {
+			for (auto &directory : level) {
+				auto candidate = directory + "/" + component;
+				if (fs.DirectoryExists(candidate)) {
+					next.push_back(std::move(candidate));
+				}
+			}
+		} else {
+			// '{a,b}' is not understood by the member matcher: take every
+			// subdirectory, which only ever checks more than needed
+			bool match_all = component.find('{') != string::npos;
+			for (auto &directory : level) {
+				vector<string> names;
+				ListSubdirectories(fs, directory, names);
+				for (auto &name : names) {
+					if (match_all || MatchArchiveMember(component, name)) {
+						next.push_back(directory + "/" + name);
+					}
+				}
+			}
+		}
+		for (auto &directory : next) {
+			result.insert(directory);
+		}
+		level = std::move(next);
+	}
+	return result;
+}
+
+shared_ptr<LineGlobCache> LineGlobCache::Get(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<LineGlobCache>(ObjectType());
+}
+
+optional_idx LineGlobCache::GetEstimatedCacheMemory() const {
+	lock_guard<mutex> guard(lock);
+	idx_t result = 0;
+	for (auto &entry : entries) {
+		result += entry.first.size();
+		for (auto &file : entry.second.files) {
+			result += sizeof(OpenFileInfo) + file.path.size();
+		}
+		for (auto &directory : entry.second.directories) {
+			result += sizeof(directory) + directory.first.size();
+		}
+	}
+	return optional_idx(result);
+}
+
+bool LineGlobCache::Lookup(FileSystem &fs, const string &pattern, int64_t ttl_us, vector<OpenFileInfo> &result) {
+	vector<OpenFileInfo> files;
+	vector<std::pair<string, int64_t>> directories;
+	{
+		lock_guard<mutex> guard(lock);
+		auto entry = entries.find(pattern);
+		if (entry == entries.end()) {
+			return false;
+		}
+		auto age = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+		                                                                  entry->second.stored);
+		if (age.count() >= ttl_us) {
+			return false; // Replaced by the caller's fresh listing
+		}
+		files = entry->second.files;
+		directories = entry->second.directories;
+	}
+	// Checked without the lock: on a network file system each check is a
+	// round trip, and other binds should not queue behind them
+	for (auto &directory : directories) {
+		int64_t modified;
+		if (!DirectoryModifiedTime(fs, directory.first, modified) || modified != directory.second) {
+			return false;
+		}
+	}
+	result = std::move(files);
+	return true;
+}
+
+void LineGlobCache::Store(FileSystem &fs, const string &pattern, const vector<OpenFileInfo> &files,
+                          int64_t listed_at) {
+	Entry entry;
+	// Paths only: a size or modification time from the listing would be
+	// reported for a file that has changed since
+	for (auto &file : files) {
+		entry.files.emplace_back(file.path);
+	}
+	entry.stored = std::chrono::steady_clock::now();
+	if (!IsRemotePath(pattern)) {
+		for (auto &directory : ListedDirectories(fs, pattern)) {
+			int64_t modified;
+			// A directory changed in the second of the listing may change
+			// again without its time moving: only cache settled listings
+			if (!DirectoryModifiedTime(fs, directory, modified) || modified >= listed_at) {
+				return;
+			}
+			entry.directories.emplace_back(directory, modified);
+		}
+	}
+	lock_guard<mutex> guard(lock);
+	if (entries.find(pattern) == entries.end()) {
+		insertion_order.push_back(pattern);
+	}
+	entries[pattern] = std::move(entry);
+	while (entries.size() > MAX_ENTRIES) {
+		entries.erase(insertion_order.front());
+		insertion_order.pop_front();
+	}
+}
+
+// A local path without wildcards names at most one file, which a single
+// existence check finds without the glob machinery. Remote paths, '~' paths
+// and shellfs commands ('cmd |') keep going through GlobFiles, which may
+// treat them differently.
+static bool IsLiteralLocalPath(const string &path) {
+	return !path.empty() && path[0] != '~' && !FileSystem::HasGlob(path) && !IsRemotePath(path) &&
+	       path.find('|') == string::npos;
+}
+
+vector<OpenFileInfo> GlobLineFiles(ClientContext &context, FileSystem &fs, const string &pattern) {
+	if (IsLiteralLocalPath(pattern)) {
+		vector<OpenFileInfo> files;
+		if (fs.FileExists(pattern) || fs.IsPipe(pattern)) {
+			files.emplace_back(pattern);
+		}
+		return files;
+	}
+	Value ttl_value;
+	int64_t ttl_us = 0;
+	if (context.TryGetCurrentSetting(GLOB_CACHE_TTL_SETTING, ttl_value) && !ttl_value.IsNull()) {
+		ttl_us = Interval::GetMicro(ttl_value.GetValue<interval_t>());
+	}
+	if (ttl_us <= 0) {
+		return compat::GlobFilesCompat(fs, pattern, context, FileGlobOptions::ALLOW_EMPTY);
+	}
+	auto cache = LineGlobCache::Get(context);
+	vector<OpenFileInfo> files;
+	if (cache->Lookup(fs, pattern, ttl_us, files)) {
+		return files;
+	}
+	auto listed_at = static_cast<int64_t>(std::time(nullptr));
+	files = compat::GlobFilesCompat(fs, pattern, context, FileGlobOptions::ALLOW_EMPTY);
+	// Patterns that match nothing are not cached: they are often probes
+	// (a path with an embedded line spec is first globbed as written)
+	if (!files.empty()) {
+		cache->Store(fs, pattern, files, listed_at);
+	}
+	return files;
+}
+
+} // namespace duckdb
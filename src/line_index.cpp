@@ -0,0 +1,648 @@
+#include "line_index.hpp"
+#include "buffered_line_reader.hpp"
+#include "compat.hpp"
+#include "duckdb_compat.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include <cstring>
+#include <ctime>
+
+namespace duckdb {
+
+LineTimestampParser::LineTimestampParser(string format_p) : format_string(std::move(format_p)) {
+	auto error = StrpTimeFormat::ParseFormatSpecifier(format_string, format);
+	if (!error.empty()) {
+		throw InvalidInputException("Invalid timestamp_format \"%s\": %s", format_string, error);
+	}
+	field_count = 1;
+	for (idx_t i = 0; i < format_string.size(); i++) {
+		if (format_string[i] == ' ' && (i == 0 || format_string[i - 1] != ' ')) {
+			field_count++;
+		}
+	}
+}
+
+static inline bool IsFieldSpace(char c) {
+	return c == ' ' || c == '\t';
+}
+
+bool LineTimestampParser::Parse(const char *data, idx_t size, timestamp_t &result) const {
+	idx_t begin = 0;
+	while (begin < size && IsFieldSpace(data[begin])) {
+		begin++;
+	}
+	// End of the field_count-th whitespace-separated field
+	idx_t end = begin;
+	for (idx_t field = 0; field < field_count; field++) {
+		while (end < size && IsFieldSpace(data[end])) {
+			end++;
+		}
+		while (end < size && !IsFieldSpace(data[end]) && data[end] != '\n' && data[end] != '\r') {
+			end++;
+		}
+	}
+	if (end == begin) {
+		return false;
+	}
+	StrpTimeFormat::ParseResult parsed;
+	return format.Parse(data + begin, end - begin, parsed) && parsed.TryToTimestamp(result);
+}
+
+bool GetFileIdentity(FileHandle &handle, FileIdentity &result) {
+	if (!handle.CanSeek()) {
+		return false;
+	}
+	try {
+		result.taken_at = static_cast<int64_t>(std::time(nullptr));
+		result.size = static_cast<int64_t>(handle.GetFileSize());
+		auto last_modified = handle.file_system.GetLastModifiedTime(handle);
+		result.last_modified = compat::LastModifiedValue(last_modified);
+		result.modified_second = Timestamp::GetEpochSeconds(compat::LastModifiedTimestamp(last_modified));
+	} catch (std::exception &) {
+		return false;
+	}
+	return true;
+}
+
+// Two bloom bit positions per trigram, from one multiplicative hash.
+static inline void TrigramBits(uint32_t trigram, idx_t &bit1, idx_t &bit2) {
+	uint64_t h = static_cast<uint64_t>(trigram) * 0x9E3779B97F4A7C15ULL;
+	bit1 = static_cast<idx_t>(h >> 47) & (LineIndex::BLOOM_BITS - 1);
+	bit2 = static_cast<idx_t>(h >> 13) & (LineIndex::BLOOM_BITS - 1);
+}
+
+static inline uint32_t Trigram(const char *data) {
+	return static_cast<uint32_t>(static_cast<uint8_t>(data[0])) << 16 |
+	       static_cast<uint32_t>(static_cast<uint8_t>(data[1])) << 8 | static_cast<uint8_t>(data[2]);
+}
+
+static void AddLineTrigrams(vector<uint64_t> &bloom, const char *data, idx_t size) {
+	for (idx_t i = 0; i + 3 <= size; i++) {
+		idx_t bit1, bit2;
+		TrigramBits(Trigram(data + i), bit1, bit2);
+		bloom[bit1 >> 6] |= uint64_t(1) << (bit1 & 63);
+		bloom[bit2 >> 6] |= uint64_t(1) << (bit2 & 63);
+	}
+}
+
+bool LineIndex::BlockMayContain(idx_t block, const vector<string> &tokens) const {
+	auto &bloom = blocks[block].trigram_bloom;
+	if (bloom.empty()) {
+		return true;
+	}
+	for (auto &token : tokens) {
+		for (idx_t i = 0; i + 3 <= token.size(); i++) {
+			idx_t bit1, bit2;
+			TrigramBits(Trigram(token.data() + i), bit1, bit2);
+			if (!(bloom[bit1 >> 6] & (uint64_t(1) << (bit1 & 63))) ||
+			    !(bloom[bit2 >> 6] & (uint64_t(1) << (bit2 & 63)))) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool LineIndex::BlockMayOverlap(idx_t block, timestamp_t lower, timestamp_t upper) const {
+	if (timestamp_format.empty()) {
+		return true;
+	}
+	auto &entry = blocks[block];
+	// Lines without a timestamp never satisfy a time predicate
+	return entry.has_time && entry.max_time >= lower && entry.min_time <= upper;
+}
+
+// Hash of the first and last CHECK_BYTES of the file's first `end` bytes.
+static hash_t PrefixHash(FileHandle &handle, int64_t end) {
+	auto head = MinValue<idx_t>(LineIndex::CHECK_BYTES, static_cast<idx_t>(end));
+	auto tail_start = MaxValue<idx_t>(head, static_cast<idx_t>(end) - MinValue<idx_t>(LineIndex::CHECK_BYTES, end));
+	string bytes(head + static_cast<idx_t>(end) - tail_start, '\0');
+	if (head > 0) {
+		handle.Read(&bytes[0], head, 0);
+	}
+	if (bytes.size() > head) {
+		handle.Read(&bytes[head], bytes.size() - head, tail_start);
+	}
+	return Hash(bytes.data(), bytes.size());
+}
+
+bool LineIndex::IsCurrent(FileHandle &handle, const FileIdentity &identity_p) const {
+	if (identity != identity_p) {
+		return false;
+	}
+	try {
+		return PrefixHash(handle, identity.size) == content_hash;
+	} catch (std::exception &) {
+		return false;
+	}
+}
+
+// Index the lines from `start_offset`, a line start where `handle` is
+// positioned and which is line `first_line`, up to `end_offset`, appending
+// blocks; returns the last line's number. A file still being written stops at
+// the size the index is validated against.
+int64_t LineIndex::IndexLines(FileHandle &handle, int64_t start_offset, int64_t end_offset, int64_t first_line,
+                              const LineTimestampParser *timestamps) {
+	BufferedLineReader reader(handle, start_offset);
+	reader.SetSnapshot(end_offset, false);
+	const char *line;
+	idx_t line_size;
+	int64_t offset;
+	int64_t line_number = first_line - 1;
+	LineIndexBlock *block = nullptr;
+	bool trigrams = has_trigrams;
+	while (reader.NextLine(line, line_size, offset)) {
+		line_number++;
+		// Cut a new block at the first line starting BLOCK_SIZE bytes or more
+		// past the current block's start.
+		if (!block || offset - block->byte_start >= static_cast<int64_t>(BLOCK_SIZE)) {
+			blocks.emplace_back();
+			block = &blocks.back();
+			block->byte_start = offset;
+			block->first_line = line_number;
+			if (trigrams) {
+				block->trigram_bloom.resize(BLOOM_BITS / 64, 0);
+			}
+		}
+		block->line_count++;
+		if (trigrams) {
+			AddLineTrigrams(block->trigram_bloom, line, line_size);
+		}
+		timestamp_t time;
+		if (timestamps && timestamps->Parse(line, line_size, time)) {
+			if (!block->has_time) {
+				block->has_time = true;
+				block->min_time = time;
+				block->max_time = time;
+			} else if (time < block->min_time) {
+				block->min_time = time;
+			} else if (time > block->max_time) {
+				block->max_time = time;
+			}
+		}
+	}
+	return line_number;
+}
+
+shared_ptr<LineIndex> LineIndex::Build(const string &path, FileHandle &handle, const FileIdentity &identity,
+                                       bool trigrams, const LineTimestampParser *timestamps) {
+	auto index = make_shared_ptr<LineIndex>();
+	index->path = path;
+	index->identity = identity;
+	index->has_trigrams = trigrams;
+	if (timestamps) {
+		index->timestamp_format = timestamps->Format();
+	}
+	index->total_lines = index->IndexLines(handle, 0, identity.size, 1, timestamps);
+	index->prefix_hash = PrefixHash(handle, index->StableEnd());
+	index->content_hash = PrefixHash(handle, identity.size);
+	return index;
+}
+
+shared_ptr<LineIndex> LineIndex::Extend(const LineIndex &previous, FileHandle &handle, const FileIdentity &identity) {
+	auto stable_end = previous.StableEnd();
+	if (identity.size <= previous.identity.size || PrefixHash(handle, stable_end) != previous.prefix_hash) {
+		return nullptr;
+	}
+	auto index = make_shared_ptr<LineIndex>(previous);
+	index->identity = identity;
+	unique_ptr<LineTimestampParser> timestamps;
+	if (!index->timestamp_format.empty()) {
+		timestamps = make_uniq<LineTimestampParser>(index->timestamp_format);
+	}
+	// The last block may have ended mid-line or short: index it again
+	int64_t first_line = 1;
+	if (!index->blocks.empty()) {
+		first_line = index->blocks.back().first_line;
+		index->blocks.pop_back();
+	}
+	handle.Seek(static_cast<idx_t>(stable_end));
+	index->total_lines = index->IndexLines(handle, stable_end, identity.size, first_line, timestamps.get());
+	index->prefix_hash = PrefixHash(handle, index->StableEnd());
+	index->content_hash = PrefixHash(handle, identity.size);
+	return index;
+}
+
+int64_t LineIndex::NextLineStart(FileHandle &handle, int64_t offset, int64_t size) {
+	if (offset <= 0 || offset >= size) {
+		return MinValue<int64_t>(MaxValue<int64_t>(offset, 0), size);
+	}
+	// A line starts after '\n', and after a '\r' not followed by '\n'
+	char buffer[4096];
+	bool after_cr = false;
+	for (int64_t pos = offset - 1; pos < size;) {
+		auto count = MinValue<int64_t>(sizeof(buffer), size - pos);
+		handle.Read(buffer, static_cast<idx_t>(count), static_cast<idx_t>(pos));
+		for (int64_t i = 0; i < count; i++) {
+			if (after_cr) {
+				return buffer[i] == '\n' ? pos + i + 1 : pos + i;
+			}
+			if (buffer[i] == '\n') {
+				return pos + i + 1;
+			}
+			after_cr = buffer[i] == '\r';
+		}
+		pos += count;
+	}
+	return size;
+}
+
+vector<LineIndexBlock> LineIndex::IndexPart(FileHandle &handle, int64_t start, int64_t end) {
+	LineIndex part;
+	if (start < end) {
+		handle.Seek(static_cast<idx_t>(start));
+		part.IndexLines(handle, start, end, 1, nullptr);
+	}
+	return std::move(part.blocks);
+}
+
+shared_ptr<LineIndex> LineIndex::Assemble(const string &path, FileHandle &handle, const FileIdentity &identity,
+                                          vector<vector<LineIndexBlock>> parts) {
+	auto index = make_shared_ptr<LineIndex>();
+	index->path = path;
+	index->identity = identity;
+	for (auto &part : parts) {
+		auto part_base = index->total_lines;
+		for (auto &block : part) {
+			block.first_line += part_base;
+			index->total_lines += block.line_count;
+			index->blocks.push_back(std::move(block));
+		}
+	}
+	index->prefix_hash = PrefixHash(handle, index->StableEnd());
+	index->content_hash = PrefixHash(handle, identity.size);
+	return index;
+}
+
+shared_ptr<LineIndex> LineIndex::Find(FileSystem &fs, const string &path, FileHandle &handle,
+                                      const FileIdentity &identity, bool settled_only) {
+	auto &cache = LineIndexCache::Get();
+	auto cached = cache.Lookup(path);
+	if (cached && cached->identity == identity) {
+		if (cached->IsCurrent(handle, identity) && (!settled_only || cached->IsSettled())) {
+			return cached;
+		}
+		// Rewritten in place at the same size and time, or possibly so: not
+		// extendable either
+		cached = nullptr;
+	}
+	auto sidecar = ReadSidecar(fs, path);
+	if (sidecar && sidecar->identity == identity) {
+		if (sidecar->IsCurrent(handle, identity) && (!settled_only || sidecar->IsSettled())) {
+			cache.Store(sidecar);
+			return sidecar;
+		}
+		sidecar = nullptr;
+	}
+	// Extend whichever earlier version got furthest
+	auto previous = cached;
+	if (sidecar && (!previous || sidecar->identity.size > previous->identity.size)) {
+		previous = sidecar;
+	}
+	if (!previous) {
+		return nullptr;
+	}
+	shared_ptr<LineIndex> index;
+	try {
+		index = Extend(*previous, handle, identity);
+		handle.Seek(0);
+	} catch (std::exception &) {
+		// Read as if there were no index
+		handle.Seek(0);
+		return nullptr;
+	}
+	if (!index) {
+		return nullptr;
+	}
+	cache.Store(index);
+	if (previous == sidecar) {
+		// Keep the sidecar current, so the next process extends from here
+		try {
+			index->WriteSidecar(fs);
+		} catch (std::exception &) {
+		}
+	}
+	return index;
+}
+
+// -----------------------------------------------------------------------------
+// Sidecar file: a fixed header followed by the blocks, in native byte order
+// (the sidecar is a cache, not an interchange format).
+// -----------------------------------------------------------------------------
+
+static constexpr const char SIDECAR_MAGIC[8] = {'R', 'L', 'I', 'D', 'X', '0', '0', '4'};
+
+template <class T>
+static void WriteSidecarValue(string &out, T value) {
+	out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+static bool ReadSidecarValue(const string &in, idx_t &pos, T &value) {
+	if (pos + sizeof(T) > in.size()) {
+		return false;
+	}
+	memcpy(&value, in.data() + pos, sizeof(T));
+	pos += sizeof(T);
+	return true;
+}
+
+string LineIndex::SidecarPath(const string &path) {
+	return path + ".lines.idx";
+}
+
+void LineIndex::WriteSidecar(FileSystem &fs) const {
+	string out(SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC));
+	WriteSidecarValue<int64_t>(out, identity.size);
+	WriteSidecarValue<int64_t>(out, identity.last_modified);
+	WriteSidecarValue<int64_t>(out, identity.modified_second);
+	WriteSidecarValue<int64_t>(out, identity.taken_at);
+	WriteSidecarValue<int64_t>(out, total_lines);
+	WriteSidecarValue<uint64_t>(out, prefix_hash);
+	WriteSidecarValue<uint64_t>(out, content_hash);
+	WriteSidecarValue<uint8_t>(out, has_trigrams ? 1 : 0);
+	WriteSidecarValue<uint64_t>(out, timestamp_format.size());
+	out += timestamp_format;
+	WriteSidecarValue<uint64_t>(out, blocks.size());
+	for (auto &block : blocks) {
+		WriteSidecarValue<int64_t>(out, block.byte_start);
+		WriteSidecarValue<int64_t>(out, block.first_line);
+		WriteSidecarValue<int64_t>(out, block.line_count);
+		WriteSidecarValue<uint8_t>(out, block.has_time ? 1 : 0);
+		WriteSidecarValue<int64_t>(out, block.has_time ? block.min_time.value : 0);
+		WriteSidecarValue<int64_t>(out, block.has_time ? block.max_time.value : 0);
+		if (has_trigrams) {
+			out.append(reinterpret_cast<const char *>(block.trigram_bloom.data()),
+			           block.trigram_bloom.size() * sizeof(uint64_t));
+		}
+	}
+	auto handle = fs.OpenFile(SidecarPath(path), FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	handle->Write(const_cast<char *>(out.data()), out.size());
+	handle->Sync();
+}
+
+// The sidecar of `path`, for whichever file version it was written
+shared_ptr<LineIndex> LineIndex::ReadSidecar(FileSystem &fs, const string &path) {
+	string in;
+	try {
+		auto flags = FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS;
+		auto handle = fs.OpenFile(SidecarPath(path), flags);
+		if (!handle) {
+			return nullptr;
+		}
+		in.resize(handle->GetFileSize());
+		if (handle->Read(&in[0], in.size()) != static_cast<int64_t>(in.size())) {
+			return nullptr;
+		}
+	} catch (std::exception &) {
+		return nullptr;
+	}
+	if (in.size() < sizeof(SIDECAR_MAGIC) || memcmp(in.data(), SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC)) != 0) {
+		return nullptr;
+	}
+
+	auto index = make_shared_ptr<LineIndex>();
+	index->path = path;
+	idx_t pos = sizeof(SIDECAR_MAGIC);
+	uint8_t has_trigrams;
+	uint64_t prefix_hash;
+	uint64_t content_hash;
+	uint64_t format_size;
+	uint64_t block_count;
+	if (!ReadSidecarValue(in, pos, index->identity.size) || !ReadSidecarValue(in, pos, index->identity.last_modified) ||
+	    !ReadSidecarValue(in, pos, index->identity.modified_second) ||
+	    !ReadSidecarValue(in, pos, index->identity.taken_at) || !ReadSidecarValue(in, pos, index->total_lines) ||
+	    !ReadSidecarValue(in, pos, prefix_hash) || !ReadSidecarValue(in, pos, content_hash) ||
+	    !ReadSidecarValue(in, pos, has_trigrams) || !ReadSidecarValue(in, pos, format_size) ||
+	    pos + format_size > in.size()) {
+		return nullptr;
+	}
+	index->prefix_hash = prefix_hash;
+	index->content_hash = content_hash;
+	index->has_trigrams = has_trigrams != 0;
+	index->timestamp_format = in.substr(pos, format_size);
+	pos += format_size;
+	if (!ReadSidecarValue(in, pos, block_count)) {
+		return nullptr;
+	}
+	idx_t bloom_bytes = index->has_trigrams ? BLOOM_BITS / 8 : 0;
+	for (uint64_t i = 0; i < block_count; i++) {
+		LineIndexBlock block;
+		uint8_t has_time;
+		int64_t min_time, max_time;
+		if (!ReadSidecarValue(in, pos, block.byte_start) || !ReadSidecarValue(in, pos, block.first_line) ||
+		    !ReadSidecarValue(in, pos, block.line_count) || !ReadSidecarValue(in, pos, has_time) ||
+		    !ReadSidecarValue(in, pos, min_time) || !ReadSidecarValue(in, pos, max_time) ||
+		    pos + bloom_bytes > in.size()) {
+			return nullptr;
+		}
+		block.has_time = has_time != 0;
+		block.min_time = timestamp_t(min_time);
+		block.max_time = timestamp_t(max_time);
+		if (bloom_bytes > 0) {
+			block.trigram_bloom.resize(BLOOM_BITS / 64);
+			memcpy(block.trigram_bloom.data(), in.data() + pos, bloom_bytes);
+			pos += bloom_bytes;
+		}
+		index->blocks.push_back(std::move(block));
+	}
+	return index;
+}
+
+LineIndexCache &LineIndexCache::Get() {
+	static LineIndexCache cache;
+	return cache;
+}
+
+shared_ptr<LineIndex> LineIndexCache::Lookup(const string &path) {
+	lock_guard<mutex> guard(lock);
+	auto entry = entries.find(path);
+	return entry == entries.end() ? nullptr : entry->second;
+}
+
+void LineIndexCache::Store(shared_ptr<LineIndex> index) {
+	lock_guard<mutex> guard(lock);
+	auto path = index->path;
+	if (entries.find(path) == entries.end()) {
+		insertion_order.push_back(path);
+	}
+	entries[path] = std::move(index);
+	while (entries.size() > MAX_ENTRIES) {
+		entries.erase(insertion_order.front());
+		insertion_order.pop_front();
+	}
+}
+
+// =============================================================================
+// build_ngram_index(glob) / build_time_index(glob): index every matching file
+// into the line index cache, returning one row per block.
+//   - build_ngram_index adds trigram blooms; read_lines then skips blocks that
+//     cannot contain a pushed-down LIKE / contains() literal on `content`.
+//   - build_time_index adds per-block timestamp ranges; read_lines then skips
+//     blocks outside a pushed-down range on `line_timestamp`.
+// Rebuilding a file keeps what an earlier build of the same file version
+// indexed, so both kinds of skipping can apply at once. With sidecar := true
+// the index is also written next to each file.
+// =============================================================================
+
+struct BuildLineIndexBindData : public TableFunctionData {
+	vector<OpenFileInfo> files;
+	bool trigrams = false;
+	unique_ptr<LineTimestampParser> timestamps;
+	bool sidecar = false;
+};
+
+struct BuildLineIndexGlobalState : public GlobalTableFunctionState {
+	idx_t file_index = 0;
+	shared_ptr<LineIndex> index; // File whose blocks are being emitted
+	idx_t block_index = 0;
+	FileSystem *fs = nullptr;
+
+	idx_t MaxThreads() const override {
+		return 1;
+	}
+};
+
+static unique_ptr<FunctionData> BuildLineIndexBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names,
+                                                   bool timestamps) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto pattern = input.inputs[0].GetValue<string>();
+	auto result = make_uniq<BuildLineIndexBindData>();
+	result->files = compat::GlobFilesCompat(fs, pattern, context, FileGlobOptions::ALLOW_EMPTY);
+	if (result->files.empty()) {
+		throw IOException("No files found that match the pattern \"%s\"", pattern);
+	}
+	result->trigrams = !timestamps;
+	string timestamp_format = LineTimestampParser::DEFAULT_FORMAT;
+	for (auto &param : input.named_parameters) {
+		if (param.first == "timestamp_format") {
+			timestamp_format = param.second.GetValue<string>();
+		} else if (param.first == "sidecar") {
+			result->sidecar = !param.second.IsNull() && param.second.GetValue<bool>();
+		}
+	}
+	if (timestamps) {
+		result->timestamps = make_uniq<LineTimestampParser>(timestamp_format);
+	}
+
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("file_path");
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("block");
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("byte_offset");
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("first_line");
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("line_count");
+	if (timestamps) {
+		return_types.push_back(LogicalType::TIMESTAMP);
+		names.push_back("min_timestamp");
+		return_types.push_back(LogicalType::TIMESTAMP);
+		names.push_back("max_timestamp");
+	}
+	return std::move(result);
+}
+
+static unique_ptr<FunctionData> BuildNgramIndexBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	return BuildLineIndexBind(context, input, return_types, names, false);
+}
+
+static unique_ptr<FunctionData> BuildTimeIndexBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	return BuildLineIndexBind(context, input, return_types, names, true);
+}
+
+static unique_ptr<GlobalTableFunctionState> BuildLineIndexInit(ClientContext &context,
+                                                               TableFunctionInitInput &input) {
+	auto result = make_uniq<BuildLineIndexGlobalState>();
+	result->fs = &FileSystem::GetFileSystem(context);
+	return std::move(result);
+}
+
+// Index one file, keeping whatever a cached index of the same file version
+// already covers. An index of an earlier version of an appended file is
+// extended rather than rebuilt.
+static shared_ptr<LineIndex> BuildFileIndex(FileSystem &fs, const BuildLineIndexBindData &bind_data,
+                                            const string &path) {
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+	FileIdentity identity;
+	if (!GetFileIdentity(*handle, identity)) {
+		throw InvalidInputException("Cannot index \"%s\": not a seekable file", path);
+	}
+	bool trigrams = bind_data.trigrams;
+	unique_ptr<LineTimestampParser> cached_timestamps;
+	const LineTimestampParser *timestamps = bind_data.timestamps.get();
+	auto cached = LineIndex::Find(fs, path, *handle, identity);
+	if (cached && (!trigrams || cached->HasTrigrams()) &&
+	    (!timestamps || cached->HasTimestamps(timestamps->Format()))) {
+		// Already indexed as asked, or extended to cover what was appended
+		if (bind_data.sidecar) {
+			cached->WriteSidecar(fs);
+		}
+		return cached;
+	}
+	if (cached) {
+		trigrams = trigrams || cached->HasTrigrams();
+		if (!timestamps && !cached->timestamp_format.empty()) {
+			cached_timestamps = make_uniq<LineTimestampParser>(cached->timestamp_format);
+			timestamps = cached_timestamps.get();
+		}
+	}
+	auto index = LineIndex::Build(path, *handle, identity, trigrams, timestamps);
+	LineIndexCache::Get().Store(index);
+	if (bind_data.sidecar) {
+		index->WriteSidecar(fs);
+	}
+	return index;
+}
+
+static void BuildLineIndexScan(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &bind_data = data_p.bind_data->Cast<BuildLineIndexBindData>();
+	auto &state = data_p.global_state->Cast<BuildLineIndexGlobalState>();
+
+	idx_t output_row = 0;
+	while (output_row < STANDARD_VECTOR_SIZE) {
+		if (!state.index || state.block_index >= state.index->blocks.size()) {
+			if (state.file_index >= bind_data.files.size()) {
+				break;
+			}
+			state.index = BuildFileIndex(*state.fs, bind_data, bind_data.files[state.file_index++].path);
+			state.block_index = 0;
+			continue;
+		}
+		auto &block = state.index->blocks[state.block_index];
+		output.data[0].SetValue(output_row, Value(state.index->path));
+		output.data[1].SetValue(output_row, Value::BIGINT(static_cast<int64_t>(state.block_index)));
+		output.data[2].SetValue(output_row, Value::BIGINT(block.byte_start));
+		output.data[3].SetValue(output_row, Value::BIGINT(block.first_line));
+		output.data[4].SetValue(output_row, Value::BIGINT(block.line_count));
+		if (bind_data.timestamps) {
+			output.data[5].SetValue(output_row, block.has_time ? Value::TIMESTAMP(block.min_time) : Value());
+			output.data[6].SetValue(output_row, block.has_time ? Value::TIMESTAMP(block.max_time) : Value());
+		}
+		state.block_index++;
+		output_row++;
+	}
+	CompatSetOutputCardinality(output, output_row);
+}
+
+TableFunction BuildNgramIndexFunction() {
+	TableFunction func("build_ngram_index", {LogicalType::VARCHAR}, BuildLineIndexScan, BuildNgramIndexBind,
+	                   BuildLineIndexInit);
+	func.named_parameters["sidecar"] = LogicalType::BOOLEAN;
+	return func;
+}
+
+TableFunction BuildTimeIndexFunction() {
+	TableFunction func("build_time_index", {LogicalType::VARCHAR}, BuildLineIndexScan, BuildTimeIndexBind,
+	                   BuildLineIndexInit);
+	func.named_parameters["timestamp_format"] = LogicalType::VARCHAR;
+	func.named_parameters["sidecar"] = LogicalType::BOOLEAN;
+	return func;
+}
+
+} // namespace duckdb
@@ -0,0 +1,147 @@
+#include "line_matcher.hpp"
+#include "read_lines_extension.hpp"
+#include <cstring>
+#include <queue>
+
+namespace duckdb {
+
+constexpr int32_t LineMatcher::NO_MATCH;
+
+LineMatcher::LineMatcher(vector<string> patterns_p) : patterns(std::move(patterns_p)) {
+	if (patterns.empty()) {
+		throw InvalidInputException("match_any needs at least one pattern");
+	}
+	for (auto &pattern : patterns) {
+		if (pattern.empty()) {
+			throw InvalidInputException("match pattern must not be empty");
+		}
+	}
+	if (patterns.size() > 1) {
+		BuildAutomaton();
+	}
+}
+
+void LineMatcher::BuildAutomaton() {
+	// Byte classes: one per distinct pattern byte, class 0 for the rest
+	memset(byte_class, 0, sizeof(byte_class));
+	class_count = 1;
+	for (auto &pattern : patterns) {
+		for (auto c : pattern) {
+			auto byte = static_cast<uint8_t>(c);
+			if (byte_class[byte] == 0) {
+				byte_class[byte] = static_cast<uint16_t>(class_count++);
+			}
+		}
+	}
+
+	// Trie, with 0 standing for "no edge yet" (no edge ever leads to the root)
+	transitions.assign(class_count, 0);
+	state_match.assign(1, NO_MATCH);
+	for (idx_t id = 0; id < patterns.size(); id++) {
+		uint32_t state = 0;
+		for (auto c : patterns[id]) {
+			auto &next = transitions[state * class_count + byte_class[static_cast<uint8_t>(c)]];
+			if (next == 0) {
+				next = static_cast<uint32_t>(state_match.size());
+				state_match.push_back(NO_MATCH);
+				transitions.resize(transitions.size() + class_count, 0);
+			}
+			state = transitions[state * class_count + byte_class[static_cast<uint8_t>(c)]];
+		}
+		if (state_match[state] == NO_MATCH) {
+			state_match[state] = static_cast<int32_t>(id);
+		}
+	}
+
+	// Breadth-first: failure links, inherited matches, and the missing edges
+	// filled in from the failure state, turning the trie into a DFA
+	vector<uint32_t> failure(state_match.size(), 0);
+	std::queue<uint32_t> queue;
+	for (idx_t cls = 0; cls < class_count; cls++) {
+		auto child = transitions[cls];
+		if (child != 0) {
+			queue.push(child);
+		}
+	}
+	while (!queue.empty()) {
+		auto state = queue.front();
+		queue.pop();
+		auto fail_match = state_match[failure[state]];
+		if (fail_match != NO_MATCH && (state_match[state] == NO_MATCH || fail_match < state_match[state])) {
+			state_match[state] = fail_match;
+		}
+		for (idx_t cls = 0; cls < class_count; cls++) {
+			auto &next = transitions[state * class_count + cls];
+			auto fallback = transitions[failure[state] * class_count + cls];
+			if (next == 0) {
+				next = fallback;
+			} else {
+				failure[next] = fallback;
+				queue.push(next);
+			}
+		}
+	}
+
+	for (idx_t byte = 0; byte < 256; byte++) {
+		root_skip[byte] = transitions[byte_class[byte]] == 0;
+	}
+}
+
+bool LineMatcher::Match(const char *data, idx_t size, idx_t &pattern_id) const {
+	idx_t begin = 0;
+	idx_t end = size;
+	LineTrimBounds(data, LineTrimMode::ENDINGS, begin, end);
+	if (patterns.size() == 1) {
+		if (!MatchSingle(data, begin, end)) {
+			return false;
+		}
+		pattern_id = 0;
+		return true;
+	}
+	return MatchAutomaton(data, begin, end, pattern_id);
+}
+
+bool LineMatcher::MatchSingle(const char *data, idx_t begin, idx_t end) const {
+	auto &pattern = patterns[0];
+	if (end - begin < pattern.size()) {
+		return false;
+	}
+	// memchr for the first byte, memcmp for the rest
+	auto first = pattern[0];
+	auto last_start = data + end - pattern.size();
+	auto pos = data + begin;
+	while (pos <= last_start) {
+		pos = static_cast<const char *>(memchr(pos, first, static_cast<size_t>(last_start - pos) + 1));
+		if (!pos) {
+			return false;
+		}
+		if (memcmp(pos + 1, pattern.data() + 1, pattern.size() - 1) == 0) {
+			return true;
+		}
+		pos++;
+	}
+	return false;
+}
+
+bool LineMatcher::MatchAutomaton(const char *data, idx_t begin, idx_t end, idx_t &pattern_id) const {
+	auto bytes = reinterpret_cast<const uint8_t *>(data);
+	uint32_t state = 0;
+	for (idx_t pos = begin; pos < end; pos++) {
+		if (state == 0) {
+			while (pos < end && root_skip[bytes[pos]]) {
+				pos++;
+			}
+			if (pos == end) {
+				break;
+			}
+		}
+		state = transitions[state * class_count + byte_class[bytes[pos]]];
+		if (state_match[state] != NO_MATCH) {
+			pattern_id = static_cast<idx_t>(state_match[state]);
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace duckdb
@@ -59,7 +59,7 @@ LineSelection LineSelection::Parse(const Value &value) {
 		ranges.emplace_back(line, line);
 	} else if (type.id() == LogicalTypeId::VARCHAR) {
 		// Range string: lines := '100-200' or '42 +/-3'
-		ranges.push_back(ParseRangeString(value.GetValue<string>()));
+		ranges.push_back(ParseRangeSpec(value.GetValue<string>()));
 	} else if (type.id() == LogicalTypeId::STRUCT && IsLineStruct(type)) {
 		// Struct: lines := {start: 10, stop: 100} or {line: 42} or {lines: [1,2,3]}
 		auto struct_ranges = ParseLineStruct(value);
@@ -70,7 +70,7 @@ LineSelection LineSelection::Parse(const Value &value) {
 		for (auto &item : list_values) {
 			auto &item_type = item.type();
 			if (item_type.id() == LogicalTypeId::VARCHAR) {
-				ranges.push_back(ParseRangeString(item.GetValue<string>()));
+				ranges.push_back(ParseRangeSpec(item.GetValue<string>()));
 			} else if (item_type.id() == LogicalTypeId::STRUCT && IsLineStruct(item_type)) {
 				auto struct_ranges = ParseLineStruct(item);
 				ranges.insert(ranges.end(), struct_ranges.begin(), struct_ranges.end());
@@ -375,6 +375,47 @@ static bool ParseContextSuffix(const string &str, size_t line_spec_end, int64_t
 	return found_before || found_after;
 }
 
+bool LineSelection::TryParseRangeStringCached(const string &str, LineRange &result) {
+	struct CachedSpec {
+		bool valid;
+		int64_t start;
+		int64_t end;
+	};
+	static constexpr size_t MAX_ENTRIES = 4096;
+	static mutex lock;
+	static unordered_map<string, CachedSpec> cache;
+	{
+		lock_guard<mutex> guard(lock);
+		auto entry = cache.find(str);
+		if (entry != cache.end()) {
+			result = LineRange(entry->second.start, entry->second.end);
+			return entry->second.valid;
+		}
+	}
+	CachedSpec parsed {false, 0, 0};
+	try {
+		auto range = ParseRangeString(str);
+		parsed = CachedSpec {true, range.start, range.end};
+		result = range;
+	} catch (...) {
+	}
+	lock_guard<mutex> guard(lock);
+	if (cache.size() >= MAX_ENTRIES) {
+		// Specs are tiny and mostly repeat; start over rather than track age
+		cache.clear();
+	}
+	cache.emplace(str, parsed);
+	return parsed.valid;
+}
+
+LineRange LineSelection::ParseRangeSpec(const string &str) {
+	LineRange range(0, 0);
+	if (!TryParseRangeStringCached(str, range)) {
+		range = ParseRangeString(str); // Throws the parse error
+	}
+	return range;
+}
+
 LineRange LineSelection::ParseRangeString(const string &str) {
 	string trimmed = str;
 	StringUtil::Trim(trimmed);
@@ -546,8 +587,8 @@ vector<LineRange> LineSelection::MergeRanges(vector<LineRange> ranges) {
 		auto &last = merged.back();
 		auto &current = ranges[i];
 
-		// Check if ranges overlap or are adjacent
-		if (current.start <= last.end + 1) {
+		// Check if ranges overlap or are adjacent (an open end covers the rest)
+		if (last.end == std::numeric_limits<int64_t>::max() || current.start <= last.end + 1) {
 			// Merge by extending end if needed
 			last.end = std::max(last.end, current.end);
 		} else {
@@ -600,6 +641,17 @@ int64_t LineSelection::MaxLine() const {
 	return ranges_.back().end;
 }
 
+LineSelection LineSelection::Union(const vector<LineSelection> &selections) {
+	vector<LineRange> ranges;
+	for (auto &selection : selections) {
+		if (selection.match_all_) {
+			return All();
+		}
+		ranges.insert(ranges.end(), selection.ranges_.begin(), selection.ranges_.end());
+	}
+	return LineSelection(std::move(ranges));
+}
+
 void LineSelection::AddContext(int64_t before, int64_t after) {
 	if (match_all_) {
 		return;
@@ -733,16 +785,15 @@ std::pair<string, LineSelection> LineSelection::ParsePathWithLineSpec(const stri
 	string file_path = path.substr(0, colon_pos);
 	string line_spec = path.substr(colon_pos + 1);
 
-	// Try to parse the line spec
-	try {
-		LineRange range = ParseRangeString(line_spec);
-		vector<LineRange> ranges;
-		ranges.push_back(range);
-		return {file_path, LineSelection(std::move(ranges))};
-	} catch (...) {
-		// If parsing fails, treat the whole thing as a path
+	// Try to parse the line spec; if parsing fails, treat the whole thing
+	// as a path
+	LineRange range(0, 0);
+	if (!TryParseRangeStringCached(line_spec, range)) {
 		return {path, LineSelection::All()};
 	}
+	vector<LineRange> ranges;
+	ranges.push_back(range);
+	return {file_path, LineSelection(std::move(ranges))};
 }
 
 } // namespace duckdb
@@ -0,0 +1,541 @@
+#include "line_source.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <atomic>
+#include <cstring>
+#include <zlib.h>
+
+namespace duckdb {
+
+// =============================================================================
+// ReadAheadSource
+// =============================================================================
+
+idx_t ReadySignal::Generation() {
+	lock_guard<mutex> guard(lock);
+	return generation;
+}
+
+void ReadySignal::Wait(idx_t seen) {
+	unique_lock<mutex> guard(lock);
+	changed.wait(guard, [&]() { return generation != seen; });
+}
+
+void ReadySignal::Notify() {
+	{
+		lock_guard<mutex> guard(lock);
+		generation++;
+	}
+	changed.notify_all();
+}
+
+// =============================================================================
+// AbandonedReaders
+// =============================================================================
+
+shared_ptr<AbandonedReaders> AbandonedReaders::Get(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<AbandonedReaders>(ObjectType());
+}
+
+AbandonedReaders::~AbandonedReaders() {
+	for (auto &reader : readers) {
+		reader.thread.join();
+	}
+}
+
+void AbandonedReaders::Add(std::thread thread, shared_ptr<std::atomic<bool>> exited) {
+	lock_guard<mutex> guard(lock);
+	for (idx_t i = 0; i < readers.size();) {
+		if (*readers[i].exited) {
+			readers[i].thread.join();
+			readers[i] = std::move(readers.back());
+			readers.pop_back();
+		} else {
+			i++;
+		}
+	}
+	readers.push_back(Reader {std::move(thread), std::move(exited)});
+}
+
+ReadAheadSource::ReadAheadSource(unique_ptr<ChunkProducer> producer_p, shared_ptr<ReadySignal> signal_p)
+    : shared(make_shared_ptr<Shared>()) {
+	shared->producer = std::move(producer_p);
+	shared->signal = std::move(signal_p);
+	shared->exited = make_shared_ptr<std::atomic<bool>>(false);
+	auto state = shared;
+	thread = std::thread([state]() {
+		Run(*state);
+		// An abandoned handle is closed here, by the thread that read it
+		unique_ptr<FileHandle> handle;
+		{
+			lock_guard<mutex> guard(state->lock);
+			handle = std::move(state->abandoned_handle);
+		}
+		handle.reset();
+		*state->exited = true;
+	});
+}
+
+ReadAheadSource::~ReadAheadSource() {
+	if (thread.joinable()) {
+		Stop();
+		thread.join();
+	}
+}
+
+void ReadAheadSource::Stop() {
+	{
+		lock_guard<mutex> guard(shared->lock);
+		shared->stopping = true;
+	}
+	shared->consumed.notify_all();
+}
+
+void ReadAheadSource::Abandon(unique_ptr<FileHandle> &handle, AbandonedReaders &owner) {
+	if (!thread.joinable()) {
+		return;
+	}
+	{
+		lock_guard<mutex> guard(shared->lock);
+		shared->abandoned_handle = std::move(handle);
+	}
+	Stop();
+	owner.Add(std::move(thread), shared->exited);
+}
+
+void ReadAheadSource::Run(Shared &shared) {
+	try {
+		string chunk;
+		while (shared.producer->Next(chunk)) {
+			if (chunk.empty()) {
+				continue;
+			}
+			unique_lock<mutex> guard(shared.lock);
+			shared.consumed.wait(guard,
+			                     [&]() { return shared.stopping || shared.queued_bytes < MAX_QUEUED_BYTES; });
+			if (shared.stopping) {
+				return;
+			}
+			shared.queued_bytes += chunk.size();
+			shared.chunks.push_back(std::move(chunk));
+			chunk = string();
+			shared.produced.notify_one();
+			guard.unlock();
+			if (shared.signal) {
+				shared.signal->Notify();
+			}
+		}
+	} catch (...) {
+		lock_guard<mutex> guard(shared.lock);
+		shared.error = std::current_exception();
+	}
+	{
+		lock_guard<mutex> guard(shared.lock);
+		shared.finished = true;
+		shared.produced.notify_one();
+	}
+	if (shared.signal) {
+		shared.signal->Notify();
+	}
+}
+
+bool ReadAheadSource::Ready() {
+	lock_guard<mutex> guard(shared->lock);
+	return current_pos < current.size() || !shared->chunks.empty() || shared->finished;
+}
+
+bool ReadAheadSource::WaitReady(std::chrono::steady_clock::time_point deadline) {
+	unique_lock<mutex> guard(shared->lock);
+	return shared->produced.wait_until(
+	    guard, deadline, [&]() { return current_pos < current.size() || !shared->chunks.empty() || shared->finished; });
+}
+
+idx_t ReadAheadSource::Read(char *buffer, idx_t size) {
+	idx_t total = 0;
+	std::chrono::steady_clock::time_point deadline;
+	auto &chunks = shared->chunks;
+	while (total < size) {
+		if (current_pos >= current.size()) {
+			unique_lock<mutex> guard(shared->lock);
+			auto available = [&]() { return !chunks.empty() || shared->finished; };
+			if (total == 0) {
+				shared->produced.wait(guard, available);
+			} else if (!available()) {
+				// Small pieces (a pipe writer's flushes) are coalesced into one
+				// read until MIN_BATCH bytes are in, or COALESCE_DELAY passed
+				// since the first of them
+				if (total >= MIN_BATCH || !shared->produced.wait_until(guard, deadline, available)) {
+					break;
+				}
+			}
+			if (chunks.empty()) {
+				if (shared->error && total == 0) {
+					std::rethrow_exception(shared->error);
+				}
+				break;
+			}
+			current = std::move(chunks.front());
+			chunks.pop_front();
+			shared->queued_bytes -= current.size();
+			current_pos = 0;
+			shared->consumed.notify_one();
+		}
+		auto count = MinValue<idx_t>(size - total, current.size() - current_pos);
+		memcpy(buffer + total, current.data() + current_pos, count);
+		current_pos += count;
+		if (total == 0) {
+			deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(COALESCE_DELAY_US);
+		}
+		total += count;
+	}
+	return total;
+}
+
+// =============================================================================
+// Producers
+// =============================================================================
+
+// Reads a handle that decompresses itself (DuckDB's gzip / zstd file
+// systems), or a pipe: the read-ahead thread takes the inflation, or the
+// wait for the command's output, off the scan thread. Read sizes adapt like
+// BufferedLineReader's, and each chunk is allocated at the size actually
+// read, so a pipe's small flushes do not each pin a full-size buffer.
+class HandleChunkProducer : public ChunkProducer {
+public:
+	explicit HandleChunkProducer(FileHandle &handle) : handle(handle) {
+	}
+
+	bool Next(string &chunk) override {
+		read_buffer.resize(read_size);
+		auto bytes_read = handle.Read(&read_buffer[0], read_size);
+		if (bytes_read <= 0) {
+			return false;
+		}
+		auto received = static_cast<idx_t>(bytes_read);
+		chunk.assign(read_buffer.data(), received);
+		if (received == read_size) {
+			read_size = MinValue<idx_t>(read_size * 2, MAX_READ_SIZE);
+		} else if (received < read_size / 4) {
+			read_size = MaxValue<idx_t>(read_size / 2, MIN_READ_SIZE);
+		}
+		return true;
+	}
+
+private:
+	static constexpr idx_t MIN_READ_SIZE = 64 << 10;
+	static constexpr idx_t MAX_READ_SIZE = 1 << 20;
+	FileHandle &handle;
+	string read_buffer;
+	idx_t read_size = MIN_READ_SIZE;
+};
+
+// BGZF (bgzip / htslib) files are gzip members of at most 64 KiB, each
+// recording its own compressed size in a 'BC' extra field, so member
+// boundaries are known without inflating anything. Runs of members are
+// inflated on parallel threads and emitted in file order: the producer
+// thread and up to threads - 1 workers, started on the first round that has
+// work for them and kept until the producer is destroyed.
+class BgzfChunkProducer : public ChunkProducer {
+public:
+	BgzfChunkProducer(FileHandle &handle, const string &path, idx_t threads)
+	    : handle(handle), path(path), threads(MaxValue<idx_t>(threads, 1)) {
+	}
+	~BgzfChunkProducer() override {
+		{
+			lock_guard<mutex> guard(round_lock);
+			stopping = true;
+		}
+		round_start.notify_all();
+		for (auto &worker : workers) {
+			worker.join();
+		}
+	}
+
+	// Size of the BGZF member at `data`; 0 when `data` is not a BGZF header,
+	// or when `available` does not cover the header yet.
+	static idx_t BlockSize(const uint8_t *data, idx_t available) {
+		if (available < HEADER_PREFIX || data[0] != 0x1f || data[1] != 0x8b || data[2] != 8 || !(data[3] & 4)) {
+			return 0;
+		}
+		idx_t extra_size = data[10] | (data[11] << 8);
+		if (available < HEADER_PREFIX + extra_size) {
+			return 0;
+		}
+		auto extra = data + HEADER_PREFIX;
+		for (idx_t pos = 0; pos + 4 <= extra_size;) {
+			idx_t field_size = extra[pos + 2] | (extra[pos + 3] << 8);
+			if (extra[pos] == 'B' && extra[pos + 1] == 'C' && field_size == 2 && pos + 6 <= extra_size) {
+				return (extra[pos + 4] | (extra[pos + 5] << 8)) + 1;
+			}
+			pos += 4 + field_size;
+		}
+		return 0;
+	}
+
+	bool Next(string &chunk) override {
+		while (ready.empty()) {
+			if (!InflateRound()) {
+				return false;
+			}
+		}
+		chunk = std::move(ready.front());
+		ready.pop_front();
+		return true;
+	}
+
+private:
+	static constexpr idx_t HEADER_PREFIX = 12; // Fixed header through XLEN
+	static constexpr idx_t TRAILER_SIZE = 8;   // CRC32, ISIZE
+	static constexpr idx_t MAX_INFLATED_SIZE = 1 << 16;
+	// A batch ends at BATCH_BYTES of input or MAX_BATCH_BLOCKS members (about
+	// 1 MiB of output with full-size members), whichever comes first
+	static constexpr idx_t BATCH_BYTES = 1 << 20;
+	static constexpr idx_t MAX_BATCH_BLOCKS = 16;
+
+	struct Batch {
+		vector<std::pair<idx_t, idx_t>> blocks; // (offset in input, size)
+		string output;
+		std::exception_ptr error;
+	};
+
+	static uint32_t Load32(const uint8_t *data) {
+		return uint32_t(data[0]) | uint32_t(data[1]) << 8 | uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24;
+	}
+
+	void InflateBlock(const uint8_t *block, idx_t block_size, string &output) const {
+		idx_t header_size = HEADER_PREFIX + (block[10] | (block[11] << 8));
+		if (block_size < header_size + TRAILER_SIZE) {
+			throw IOException("read_lines: corrupt BGZF block in \"%s\"", path);
+		}
+		auto expected_crc = Load32(block + block_size - 8);
+		auto inflated_size = Load32(block + block_size - 4);
+		if (inflated_size > MAX_INFLATED_SIZE) {
+			// BGZF members hold at most 64 KiB; never size a buffer from a
+			// corrupt trailer
+			throw IOException("read_lines: corrupt BGZF block in \"%s\"", path);
+		}
+		auto start = output.size();
+		output.resize(start + inflated_size);
+		if (inflated_size == 0) {
+			return; // The empty end-of-file marker block
+		}
+
+		z_stream stream;
+		memset(&stream, 0, sizeof(stream));
+		if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+			throw IOException("read_lines: failed to initialize inflate for \"%s\"", path);
+		}
+		stream.next_in = const_cast<Bytef *>(block + header_size);
+		stream.avail_in = static_cast<uInt>(block_size - header_size - TRAILER_SIZE);
+		stream.next_out = reinterpret_cast<Bytef *>(&output[start]);
+		stream.avail_out = inflated_size;
+		auto result = inflate(&stream, Z_FINISH);
+		inflateEnd(&stream);
+		if (result != Z_STREAM_END || stream.avail_out != 0 || stream.total_out != inflated_size ||
+		    crc32(0, reinterpret_cast<const Bytef *>(&output[start]), inflated_size) != expected_crc) {
+			throw IOException("read_lines: corrupt BGZF block in \"%s\"", path);
+		}
+	}
+
+	void InflateBatch(Batch &batch) const {
+		try {
+			auto data = reinterpret_cast<const uint8_t *>(input.data());
+			for (auto &block : batch.blocks) {
+				InflateBlock(data + block.first, block.second, batch.output);
+			}
+		} catch (...) {
+			batch.error = std::current_exception();
+		}
+	}
+
+	// Inflate batches of the current round until none is left unclaimed.
+	void InflateClaimed() {
+		while (true) {
+			auto position = next_batch.fetch_add(1);
+			if (position >= round.size()) {
+				return;
+			}
+			InflateBatch(round[position]);
+			lock_guard<mutex> guard(round_lock);
+			if (--batches_left == 0) {
+				round_done.notify_all();
+			}
+		}
+	}
+
+	void Work() {
+		idx_t seen = 0;
+		unique_lock<mutex> guard(round_lock);
+		while (true) {
+			round_start.wait(guard, [&]() { return stopping || round_id != seen; });
+			if (stopping) {
+				return;
+			}
+			seen = round_id;
+			active_workers++;
+			guard.unlock();
+			InflateClaimed();
+			guard.lock();
+			if (--active_workers == 0) {
+				round_done.notify_all();
+			}
+		}
+	}
+
+	// Top up the compressed input so a full round of batches is available.
+	void FillInput() {
+		if (input_pos > 0) {
+			input.erase(0, input_pos);
+			input_pos = 0;
+		}
+		while (!input_eof && input.size() < threads * BATCH_BYTES + (64 << 10)) {
+			auto start = input.size();
+			input.resize(start + READ_SIZE);
+			auto bytes_read = handle.Read(&input[start], READ_SIZE);
+			input.resize(start + static_cast<idx_t>(MaxValue<int64_t>(bytes_read, 0)));
+			if (bytes_read <= 0) {
+				input_eof = true;
+			}
+		}
+	}
+
+	// Inflate up to `threads` batches of members in parallel. False once the
+	// input is exhausted.
+	bool InflateRound() {
+		FillInput();
+		vector<Batch> batches;
+		auto data = reinterpret_cast<const uint8_t *>(input.data());
+		while (batches.size() < threads && input_pos < input.size()) {
+			Batch batch;
+			idx_t batch_bytes = 0;
+			while (batch_bytes < BATCH_BYTES && batch.blocks.size() < MAX_BATCH_BLOCKS && input_pos < input.size()) {
+				auto available = input.size() - input_pos;
+				auto block_size = BlockSize(data + input_pos, available);
+				if (block_size == 0 || block_size > available) {
+					if (!input_eof && available < (64 << 10) + HEADER_PREFIX) {
+						break; // Block continues past the buffered input
+					}
+					throw IOException("read_lines: \"%s\" is not a complete BGZF file", path);
+				}
+				batch.blocks.emplace_back(input_pos, block_size);
+				input_pos += block_size;
+				batch_bytes += block_size;
+			}
+			if (batch.blocks.empty()) {
+				break;
+			}
+			batches.push_back(std::move(batch));
+		}
+		if (batches.empty()) {
+			return false;
+		}
+
+		if (batches.size() > 1 && workers.empty()) {
+			for (idx_t i = 1; i < threads; i++) {
+				workers.emplace_back([this]() { Work(); });
+			}
+		}
+		{
+			// A worker still waking up for the previous round must be done
+			// with it before the batches are replaced
+			unique_lock<mutex> guard(round_lock);
+			round_done.wait(guard, [&]() { return active_workers == 0; });
+			round = std::move(batches);
+			next_batch = 0;
+			batches_left = round.size();
+			round_id++;
+		}
+		round_start.notify_all();
+		InflateClaimed();
+		{
+			unique_lock<mutex> guard(round_lock);
+			round_done.wait(guard, [&]() { return batches_left == 0 && active_workers == 0; });
+		}
+		for (auto &batch : round) {
+			if (batch.error) {
+				std::rethrow_exception(batch.error);
+			}
+			ready.push_back(std::move(batch.output));
+		}
+		return true;
+	}
+
+	static constexpr idx_t READ_SIZE = 4 << 20;
+
+	FileHandle &handle;
+	string path;
+	idx_t threads;
+	string input; // Compressed bytes not yet cut into batches (from input_pos)
+	idx_t input_pos = 0;
+	bool input_eof = false;
+	std::deque<string> ready;
+
+	// The round being inflated, shared with the workers
+	vector<std::thread> workers;
+	mutex round_lock;
+	std::condition_variable round_start; // Signals workers: a new round, or stop
+	std::condition_variable round_done;  // Signals the producer: batches or workers finished
+	vector<Batch> round;
+	std::atomic<idx_t> next_batch {0};
+	idx_t batches_left = 0;
+	idx_t active_workers = 0;
+	idx_t round_id = 0;
+	bool stopping = false;
+};
+
+// =============================================================================
+// Opening
+// =============================================================================
+
+FileCompressionType ResolveLineCompression(FileCompressionType requested, const string &path) {
+	if (requested != FileCompressionType::AUTO_DETECT) {
+		return requested;
+	}
+	auto lower = StringUtil::Lower(path);
+	if (StringUtil::EndsWith(lower, ".gz") || StringUtil::EndsWith(lower, ".gzip") ||
+	    StringUtil::EndsWith(lower, ".tgz")) {
+		return FileCompressionType::GZIP;
+	}
+	if (StringUtil::EndsWith(lower, ".zst")) {
+		return FileCompressionType::ZSTD;
+	}
+	return FileCompressionType::UNCOMPRESSED;
+}
+
+// Only BGZF members carry their compressed size, which lets the workers take
+// members without inflating the ones before. Other gzip files, concatenated
+// multi-member ones included, are inflated in order on the read-ahead thread.
+static bool IsBgzfFile(FileHandle &handle) {
+	if (!handle.CanSeek()) {
+		return false;
+	}
+	uint8_t header[64];
+	auto bytes_read = handle.Read(header, sizeof(header));
+	handle.Seek(0);
+	return bytes_read > 0 && BgzfChunkProducer::BlockSize(header, static_cast<idx_t>(bytes_read)) > 0;
+}
+
+unique_ptr<ReadAheadSource> OpenReadAheadSource(FileHandle &handle, shared_ptr<ReadySignal> signal) {
+	return make_uniq<ReadAheadSource>(make_uniq<HandleChunkProducer>(handle), std::move(signal));
+}
+
+unique_ptr<LineSource> OpenDecompressingSource(FileSystem &fs, const string &path, FileCompressionType compression,
+                                               idx_t threads, unique_ptr<FileHandle> &handle) {
+	if (compression == FileCompressionType::UNCOMPRESSED || compression == FileCompressionType::AUTO_DETECT) {
+		return nullptr;
+	}
+	unique_ptr<ChunkProducer> producer;
+	if (compression == FileCompressionType::GZIP) {
+		handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+		if (IsBgzfFile(*handle)) {
+			producer = make_uniq<BgzfChunkProducer>(*handle, path, threads);
+		}
+	}
+	if (!producer) {
+		handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ | compression);
+		producer = make_uniq<HandleChunkProducer>(*handle);
+	}
+	return make_uniq<ReadAheadSource>(std::move(producer));
+}
+
+} // namespace duckdb
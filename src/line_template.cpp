@@ -0,0 +1,136 @@
+#include "read_lines_extension.hpp"
+#include <cstring>
+
+namespace duckdb {
+
+// Log template mining: one left-to-right pass over a line's bytes that copies
+// literal text and replaces the variable parts of a log message with fixed
+// placeholders, so lines that differ only in their parameters share a
+// template (and a template hash) and can be grouped directly.
+
+static bool IsWordChar(char c) {
+	return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static bool IsDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+static bool IsHexDigit(char c) {
+	return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// Number of hex digits starting at `pos` (at most `limit`).
+static idx_t HexRun(const char *data, idx_t size, idx_t pos, idx_t limit) {
+	idx_t end = pos;
+	while (end < size && end - pos < limit && IsHexDigit(data[end])) {
+		end++;
+	}
+	return end - pos;
+}
+
+// True when `pos` is a token boundary: the end of the line or a non-word byte.
+static bool AtBoundary(const char *data, idx_t size, idx_t pos) {
+	return pos >= size || !IsWordChar(data[pos]);
+}
+
+// 8-4-4-4-12 hex groups, e.g. 123e4567-e89b-12d3-a456-426614174000
+static idx_t MatchUUID(const char *data, idx_t size, idx_t pos) {
+	static const idx_t GROUPS[] = {8, 4, 4, 4, 12};
+	idx_t end = pos;
+	for (idx_t g = 0; g < 5; g++) {
+		if (g > 0) {
+			if (end >= size || data[end] != '-') {
+				return 0;
+			}
+			end++;
+		}
+		if (HexRun(data, size, end, GROUPS[g]) != GROUPS[g]) {
+			return 0;
+		}
+		end += GROUPS[g];
+	}
+	return AtBoundary(data, size, end) ? end - pos : 0;
+}
+
+// 0x-prefixed hex, or a bare hex run of 8+ digits mixing letters and decimal
+// digits (ids, hashes, addresses): not a long number, not an English word.
+static idx_t MatchHex(const char *data, idx_t size, idx_t pos) {
+	if (pos + 2 < size && data[pos] == '0' && (data[pos + 1] == 'x' || data[pos + 1] == 'X')) {
+		auto digits = HexRun(data, size, pos + 2, size);
+		if (digits > 0 && AtBoundary(data, size, pos + 2 + digits)) {
+			return 2 + digits;
+		}
+	}
+	auto digits = HexRun(data, size, pos, size);
+	if (digits < 8 || !AtBoundary(data, size, pos + digits)) {
+		return 0;
+	}
+	bool has_letter = false;
+	bool has_digit = false;
+	for (idx_t i = pos; i < pos + digits; i++) {
+		if (IsDigit(data[i])) {
+			has_digit = true;
+		} else {
+			has_letter = true;
+		}
+	}
+	return has_letter && has_digit ? digits : 0;
+}
+
+// Digits with optional dotted groups: 42, 3.14, 10.0.0.1
+static idx_t MatchNumber(const char *data, idx_t size, idx_t pos) {
+	idx_t end = pos;
+	while (end < size && IsDigit(data[end])) {
+		end++;
+	}
+	while (end + 1 < size && data[end] == '.' && IsDigit(data[end + 1])) {
+		end++;
+		while (end < size && IsDigit(data[end])) {
+			end++;
+		}
+	}
+	return end - pos;
+}
+
+void BuildLineTemplate(const char *data, idx_t size, string &result) {
+	result.clear();
+	idx_t pos = 0;
+	while (pos < size) {
+		char c = data[pos];
+		bool token_start = pos == 0 || !IsWordChar(data[pos - 1]);
+
+		// Quoted strings; a single quote only opens at a token start so that
+		// apostrophes inside words ("don't") stay literal.
+		if (c == '"' || (c == '\'' && token_start)) {
+			auto close = static_cast<const char *>(memchr(data + pos + 1, c, size - pos - 1));
+			if (close) {
+				result += "<STR>";
+				pos = static_cast<idx_t>(close - data) + 1;
+				continue;
+			}
+		}
+		if (IsDigit(c) || (token_start && IsHexDigit(c))) {
+			idx_t len;
+			if (token_start && (len = MatchUUID(data, size, pos)) > 0) {
+				result += "<UUID>";
+				pos += len;
+				continue;
+			}
+			if (token_start && (len = MatchHex(data, size, pos)) > 0) {
+				result += "<HEX>";
+				pos += len;
+				continue;
+			}
+			if (IsDigit(c)) {
+				result += "<NUM>";
+				pos += MatchNumber(data, size, pos);
+				continue;
+			}
+		}
+		result += c;
+		pos++;
+	}
+}
+
+} // namespace duckdb
@@ -4,6 +4,7 @@
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/types/data_chunk.hpp"
+#include <cstring>
 
 namespace duckdb {
 
@@ -11,9 +12,13 @@ struct ParseTextLinesBindData : public TableFunctionData {
 	string text;
 	LineSelection line_selection;
 	LineTrimMode trim_mode;
+	bool split;
+	string split_delimiter;
 
-	ParseTextLinesBindData(string text, LineSelection selection, LineTrimMode trim_mode)
-	    : text(std::move(text)), line_selection(std::move(selection)), trim_mode(trim_mode) {
+	ParseTextLinesBindData(string text, LineSelection selection, LineTrimMode trim_mode, bool split,
+	                       string split_delimiter)
+	    : text(std::move(text)), line_selection(std::move(selection)), trim_mode(trim_mode), split(split),
+	      split_delimiter(std::move(split_delimiter)) {
 	}
 };
 
@@ -43,6 +48,8 @@ static unique_ptr<FunctionData> ParseTextLinesBind(ClientContext &context, Table
 	LineTrimMode trim_mode = LineTrimMode::NONE;
 	int64_t before_context = 0;
 	int64_t after_context = 0;
+	bool split = false;
+	string split_delimiter;
 
 	for (auto &param : input.named_parameters) {
 		auto &name = param.first;
@@ -52,6 +59,8 @@ static unique_ptr<FunctionData> ParseTextLinesBind(ClientContext &context, Table
 			line_selection = LineSelection::Parse(value);
 		} else if (name == "trim") {
 			trim_mode = ParseLineTrimMode(value);
+		} else if (name == "split") {
+			split = ParseSplitDelimiter(value, split_delimiter);
 		} else if (name == "before") {
 			before_context = value.GetValue<int64_t>();
 		} else if (name == "after") {
@@ -77,7 +86,13 @@ static unique_ptr<FunctionData> ParseTextLinesBind(ClientContext &context, Table
 	return_types.push_back(LogicalType::BIGINT); // byte_offset
 	names.push_back("byte_offset");
 
-	return make_uniq<ParseTextLinesBindData>(std::move(text), std::move(line_selection), trim_mode);
+	if (split) {
+		return_types.push_back(LogicalType::LIST(LogicalType::VARCHAR)); // fields
+		names.push_back("fields");
+	}
+
+	return make_uniq<ParseTextLinesBindData>(std::move(text), std::move(line_selection), trim_mode, split,
+	                                         std::move(split_delimiter));
 }
 
 static unique_ptr<GlobalTableFunctionState> ParseTextLinesInit(ClientContext &context, TableFunctionInitInput &input) {
@@ -112,37 +127,38 @@ int64_t CountLinesInText(const string &text, idx_t start) {
 	return count;
 }
 
-// Extract a line from text starting at position, handling \n, \r\n, and \r line endings
-// Returns the line content (including line ending) and updates position to after the line
-// Shared with read_lines.cpp (declared in read_lines_extension.hpp) so that
-// buffered non-seekable streams split lines identically to parse_lines.
-string ExtractLine(const string &text, idx_t &position) {
-	if (position >= text.size()) {
-		return "";
-	}
-
-	idx_t start = position;
+idx_t FindLineEnd(const char *text, idx_t size, idx_t position) {
 	idx_t end = position;
-
-	// Find end of line
-	while (end < text.size()) {
+	while (end < size) {
 		char c = text[end];
 		if (c == '\n') {
-			end++; // Include \n
-			break;
-		} else if (c == '\r') {
+			return end + 1; // Include \n
+		}
+		if (c == '\r') {
 			end++;
 			// Check for \r\n
-			if (end < text.size() && text[end] == '\n') {
+			if (end < size && text[end] == '\n') {
 				end++;
 			}
-			break;
+			return end;
 		}
 		end++;
 	}
+	return end;
+}
 
-	position = end;
-	return text.substr(start, end - start);
+// Extract a line from text starting at position, handling \n, \r\n, and \r line endings
+// Returns the line content (including line ending) and updates position to after the line
+// Shared with read_lines.cpp (declared in read_lines_extension.hpp) so that
+// buffered non-seekable streams split lines identically to parse_lines.
+string ExtractLine(const string &text, idx_t &position) {
+	if (position >= text.size()) {
+		return "";
+	}
+
+	idx_t start = position;
+	position = FindLineEnd(text.data(), text.size(), position);
+	return text.substr(start, position - start);
 }
 
 LineTrimMode ParseLineTrimMode(const Value &value) {
@@ -178,36 +194,109 @@ static bool IsHorizontalWhitespace(char c) {
 	return c == ' ' || c == '\t';
 }
 
-string ApplyLineTrim(const string &line, LineTrimMode mode) {
-	if (mode == LineTrimMode::NONE || line.empty()) {
-		return line;
+void LineTrimBounds(const char *data, LineTrimMode mode, idx_t &begin, idx_t &end) {
+	if (mode == LineTrimMode::NONE || end == begin) {
+		return;
 	}
-	idx_t begin = 0;
-	idx_t end = line.size();
 	if (mode != LineTrimMode::LEFT) {
 		// Strip the single trailing terminator (\n, \r\n, or \r)
-		if (line[end - 1] == '\n') {
+		if (data[end - 1] == '\n') {
 			end--;
-			if (end > 0 && line[end - 1] == '\r') {
+			if (end > begin && data[end - 1] == '\r') {
 				end--;
 			}
-		} else if (line[end - 1] == '\r') {
+		} else if (data[end - 1] == '\r') {
 			end--;
 		}
 	}
 	if (mode == LineTrimMode::RIGHT || mode == LineTrimMode::BOTH) {
-		while (end > begin && IsHorizontalWhitespace(line[end - 1])) {
+		while (end > begin && IsHorizontalWhitespace(data[end - 1])) {
 			end--;
 		}
 	}
 	if (mode == LineTrimMode::LEFT || mode == LineTrimMode::BOTH) {
-		while (begin < end && IsHorizontalWhitespace(line[begin])) {
+		while (begin < end && IsHorizontalWhitespace(data[begin])) {
 			begin++;
 		}
 	}
+}
+
+string ApplyLineTrim(const string &line, LineTrimMode mode) {
+	if (mode == LineTrimMode::NONE || line.empty()) {
+		return line;
+	}
+	idx_t begin = 0;
+	idx_t end = line.size();
+	LineTrimBounds(line.data(), mode, begin, end);
 	return line.substr(begin, end - begin);
 }
 
+bool ParseSplitDelimiter(const Value &value, string &delimiter) {
+	if (value.IsNull()) {
+		return false;
+	}
+	delimiter = value.GetValue<string>();
+	if (delimiter.empty()) {
+		throw InvalidInputException("split delimiter must not be empty");
+	}
+	return true;
+}
+
+// Next occurrence of `delimiter` in [pos, end), or nullptr. memchr is the
+// vectorized search in every libc we build against; multi-byte delimiters
+// confirm each first-byte hit with a memcmp.
+static const char *FindDelimiter(const char *pos, const char *end, const string &delimiter) {
+	const char first = delimiter[0];
+	const idx_t delim_size = delimiter.size();
+	while (pos < end) {
+		auto hit = static_cast<const char *>(memchr(pos, first, static_cast<size_t>(end - pos)));
+		if (!hit || static_cast<idx_t>(end - hit) < delim_size) {
+			return nullptr;
+		}
+		if (delim_size == 1 || memcmp(hit, delimiter.data(), delim_size) == 0) {
+			return hit;
+		}
+		pos = hit + 1;
+	}
+	return nullptr;
+}
+
+void AppendLineFields(Vector &list_vector, idx_t row, const char *data, idx_t size, LineTrimMode mode,
+                      const string &delimiter) {
+	idx_t begin = 0;
+	idx_t end = size;
+	LineTrimBounds(data, mode, begin, end);
+	// Fields never carry the terminator, even for the modes that keep it in
+	// content.
+	if (mode == LineTrimMode::NONE || mode == LineTrimMode::LEFT) {
+		LineTrimBounds(data, LineTrimMode::ENDINGS, begin, end);
+	}
+	const char *field_begin = data + begin;
+	const char *line_end = data + end;
+
+	// Count first so the child vector is reserved once per line.
+	idx_t field_count = 1;
+	for (auto hit = FindDelimiter(field_begin, line_end, delimiter); hit;
+	     hit = FindDelimiter(hit + delimiter.size(), line_end, delimiter)) {
+		field_count++;
+	}
+
+	auto list_offset = ListVector::GetListSize(list_vector);
+	ListVector::Reserve(list_vector, list_offset + field_count);
+	auto &child = ListVector::GetEntry(list_vector);
+	auto child_data = FlatVector::GetData<string_t>(child);
+	for (idx_t i = 0; i < field_count; i++) {
+		auto hit = i + 1 < field_count ? FindDelimiter(field_begin, line_end, delimiter) : line_end;
+		child_data[list_offset + i] =
+		    StringVector::AddString(child, field_begin, static_cast<idx_t>(hit - field_begin));
+		field_begin = hit + delimiter.size();
+	}
+	ListVector::SetListSize(list_vector, list_offset + field_count);
+
+	auto list_data = FlatVector::GetData<list_entry_t>(list_vector);
+	list_data[row] = list_entry_t(list_offset, field_count);
+}
+
 static void ParseTextLinesFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
 	auto &bind_data = data_p.bind_data->Cast<ParseTextLinesBindData>();
 	auto &state = data_p.global_state->Cast<ParseTextLinesGlobalState>();
@@ -253,6 +342,10 @@ static void ParseTextLinesFunction(ClientContext &context, TableFunctionInput &d
 		output.data[0].SetValue(output_row, Value::BIGINT(state.current_line_number));
 		output.data[1].SetValue(output_row, Value(ApplyLineTrim(line, bind_data.trim_mode)));
 		output.data[2].SetValue(output_row, Value::BIGINT(line_start_offset));
+		if (bind_data.split) {
+			AppendLineFields(output.data[3], output_row, line.data(), line.size(), bind_data.trim_mode,
+			                 bind_data.split_delimiter);
+		}
 
 		output_row++;
 	}
@@ -271,6 +364,7 @@ TableFunction ParseLinesFunction() {
 	// Named parameters
 	func.named_parameters["lines"] = LogicalType::ANY; // Can be int, string, or list
 	func.named_parameters["trim"] = LogicalType::ANY;  // BOOLEAN or 'endings'/'left'/'right'/'both'/'none'
+	func.named_parameters["split"] = LogicalType::VARCHAR;
 	func.named_parameters["before"] = LogicalType::BIGINT;
 	func.named_parameters["after"] = LogicalType::BIGINT;
 	func.named_parameters["context"] = LogicalType::BIGINT;
@@ -1,22 +1,125 @@
 #include "read_lines_extension.hpp"
 #include "line_selection.hpp"
+#include "buffered_line_reader.hpp"
+#include "line_index.hpp"
+#include "line_matcher.hpp"
+#include "line_source.hpp"
+#include "line_archive.hpp"
+#include "line_glob_cache.hpp"
 #include "compat.hpp"
 #include "duckdb_compat.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/function/function_set.hpp"
+#include "duckdb/common/error_data.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/open_file_info.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/planner/expression/bound_between_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
 #include "utf8proc_wrapper.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 
 namespace duckdb {
 
+// What an output vector carries. The bound schema is the four base columns
+// followed by whichever optional columns the named parameters enabled; with
+// projection pushdown the scan only computes the ones a query references.
+enum class ReadLinesColumn : uint8_t {
+	LINE_NUMBER,
+	CONTENT,
+	BYTE_OFFSET,
+	FILE_PATH,
+	FIELDS,       // split := '<delimiter>'
+	CONTENT_HASH, // content_hash := true
+	TEMPLATE,     // template := true
+	TEMPLATE_HASH,
+	LINE_TIMESTAMP,     // timestamp_format := '<strptime format>'
+	MATCH_ID,           // match_any := [...]
+	MATCH_COUNT,        // count_only := true (replaces the line columns)
+	REJECT_REASON,      // rejects := true
+	GLOBAL_LINE_NUMBER, // global_line_number := true
+	SPEC_INDEX,         // Path lists whose entries carry line specs
+	FILE_INDEX,         // Virtual columns: only computed when projected
+	FILE_SIZE,
+	FILE_MTIME,
+	NONE // row-id / placeholder projections nothing reads
+};
+
+// Ids of the virtual columns, after the ones DuckDB's own file readers use
+// (filename, file_row_number, file_index)
+static constexpr column_t COLUMN_IDENTIFIER_LINES_FILE_INDEX = VIRTUAL_COLUMN_START + 3;
+static constexpr column_t COLUMN_IDENTIFIER_LINES_FILE_SIZE = VIRTUAL_COLUMN_START + 4;
+static constexpr column_t COLUMN_IDENTIFIER_LINES_FILE_MTIME = VIRTUAL_COLUMN_START + 5;
+
+// A path list entry's line selection for one of its files, with the
+// entry's 0-based position in the list (as file_index numbers files)
+struct FileLineSpec {
+	idx_t spec_index;
+	LineSelection selection;
+};
+
 struct ReadTextLinesBindData : public TableFunctionData {
 	vector<OpenFileInfo> files;
 	LineSelection line_selection;
 	LineTrimMode trim_mode;
 	bool ignore_errors;
+	vector<ReadLinesColumn> columns; // Bound schema, in output order
+	string split_delimiter;          // For FIELDS
+	// Literals every matching line's content must contain, taken from
+	// pushed-down filters; used to skip indexed blocks (see build_ngram_index)
+	vector<string> required_substrings;
+	shared_ptr<LineTimestampParser> timestamp_parser; // For LINE_TIMESTAMP
+	// match := '<literal>' / match_any := [...]: emit matching lines plus
+	// match_before / match_after lines of context around each, in one pass
+	shared_ptr<LineMatcher> matcher;
+	int64_t match_before = 0;
+	int64_t match_after = 0;
+	bool invert = false;     // invert := true: lines that do NOT match are the matches
+	bool count_only = false; // count_only := true: one (file_path, match_count) row per file
+	FileCompressionType compression = FileCompressionType::AUTO_DETECT;
+	// flush_interval := INTERVAL: once min_batch rows are in an output chunk,
+	// a source that stays quiet this long gets the chunk emitted partially
+	int64_t flush_interval_us = -1;
+	idx_t min_batch = 1;
+	// rejects := true: unreadable files and lines become rows with a
+	// reject_reason instead of being skipped silently (implies ignore_errors)
+	bool rejects = false;
+	vector<string> unmatched_paths; // Reported as rejects, when they are on
+	// global_line_number := true: files are scanned strictly in list order
+	// (pipes still run ahead, but are not taken out of turn)
+	bool global_line_number = false;
+	// snapshot := true: a file's size is pinned at bind (snapshot_sizes, by
+	// position in `files`; -1 where it is taken when the file is opened), and
+	// no pass over it (counting, index seeks, emitting) reads past that size.
+	// complete_lines := true: a last line without a terminator is left out.
+	bool snapshot = false;
+	vector<int64_t> snapshot_sizes;
+	bool complete_lines = false;
+	// parallel := true: files, and morsels of large files, are read on
+	// several threads (see PlanParallelScan); rows of different files and
+	// morsels interleave
+	bool parallel = false;
+	// Path lists with per-entry line specs ('a.py:10-20', {path, spec}): the
+	// specs naming each file, by position in `files`; empty otherwise. A file
+	// named by several entries is read once, each line emitted per entry.
+	vector<vector<FileLineSpec>> file_specs;
+	// Member pattern when `files` are archives ('bundle.tar.gz/**/*.log');
+	// each matching member is scanned as a file of its own
+	string archive_members;
+	// Range pushed-down filters require of line_timestamp; used to skip
+	// blocks of a time index (see build_time_index)
+	bool has_time_filter = false;
+	timestamp_t time_lower = timestamp_t::ninfinity();
+	timestamp_t time_upper = timestamp_t::infinity();
 
 	ReadTextLinesBindData(vector<OpenFileInfo> files, LineSelection selection, LineTrimMode trim_mode,
 	                      bool ignore_errors)
@@ -25,60 +128,783 @@ struct ReadTextLinesBindData : public TableFunctionData {
 	}
 };
 
-// Forward declaration; defined below with the shared reading helpers.
-class BufferedLineReader;
+static void AddReadLinesColumns(const vector<ReadLinesColumn> &columns, vector<LogicalType> &return_types,
+                                vector<string> &names) {
+	for (auto column : columns) {
+		switch (column) {
+		case ReadLinesColumn::LINE_NUMBER:
+			return_types.push_back(LogicalType::BIGINT);
+			names.push_back("line_number");
+			break;
+		case ReadLinesColumn::CONTENT:
+			return_types.push_back(LogicalType::VARCHAR);
+			names.push_back("content");
+			break;
+		case ReadLinesColumn::BYTE_OFFSET:
+			return_types.push_back(LogicalType::BIGINT);
+			names.push_back("byte_offset");
+			break;
+		case ReadLinesColumn::FILE_PATH:
+			return_types.push_back(LogicalType::VARCHAR);
+			names.push_back("file_path");
+			break;
+		case ReadLinesColumn::FIELDS:
+			return_types.push_back(LogicalType::LIST(LogicalType::VARCHAR));
+			names.push_back("fields");
+			break;
+		case ReadLinesColumn::CONTENT_HASH:
+			return_types.push_back(LogicalType::UBIGINT);
+			names.push_back("content_hash");
+			break;
+		case ReadLinesColumn::TEMPLATE:
+			return_types.push_back(LogicalType::VARCHAR);
+			names.push_back("template");
+			break;
+		case ReadLinesColumn::TEMPLATE_HASH:
+			return_types.push_back(LogicalType::UBIGINT);
+			names.push_back("template_hash");
+			break;
+		case ReadLinesColumn::LINE_TIMESTAMP:
+			return_types.push_back(LogicalType::TIMESTAMP);
+			names.push_back("line_timestamp");
+			break;
+		case ReadLinesColumn::MATCH_ID:
+			return_types.push_back(LogicalType::INTEGER);
+			names.push_back("match_id");
+			break;
+		case ReadLinesColumn::MATCH_COUNT:
+			return_types.push_back(LogicalType::BIGINT);
+			names.push_back("match_count");
+			break;
+		case ReadLinesColumn::REJECT_REASON:
+			return_types.push_back(LogicalType::VARCHAR);
+			names.push_back("reject_reason");
+			break;
+		case ReadLinesColumn::GLOBAL_LINE_NUMBER:
+			return_types.push_back(LogicalType::BIGINT);
+			names.push_back("global_line_number");
+			break;
+		case ReadLinesColumn::SPEC_INDEX:
+			return_types.push_back(LogicalType::BIGINT);
+			names.push_back("spec_index");
+			break;
+		case ReadLinesColumn::FILE_INDEX:
+		case ReadLinesColumn::FILE_SIZE:
+		case ReadLinesColumn::FILE_MTIME:
+		case ReadLinesColumn::NONE:
+			// Virtual columns are declared by ReadTextLinesGetVirtualColumns
+			break;
+		}
+	}
+}
 
-struct ReadTextLinesGlobalState : public GlobalTableFunctionState {
+// One emitted line, as a view into the reader's buffer (valid until the
+// reader advances).
+struct LineRow {
+	int64_t line_number;
+	const char *data;
+	idx_t size;
+	int64_t byte_offset;
+	idx_t match_id; // Pattern a match_any line matched; INVALID_INDEX for context lines
+	// rejects := true: why the line could not be read; nullptr for lines that
+	// were. A negative line_number / byte_offset is written as NULL.
+	const char *reject_reason;
+};
+
+// A line copied out of the reader's buffer, for rows that must outlive it
+// (context lines held back until a match, rows waiting for chunk space).
+struct OwnedLineRow {
+	int64_t line_number = 0;
+	int64_t byte_offset = 0;
+	idx_t match_id = DConstants::INVALID_INDEX;
+	idx_t spec_index = DConstants::INVALID_INDEX; // Entry the row is emitted for, in spec mode
+	string data;
+	string reject_reason;
+
+	void Assign(const LineRow &line) {
+		line_number = line.line_number;
+		byte_offset = line.byte_offset;
+		match_id = line.match_id;
+		data.assign(line.data, line.size);
+		reject_reason = line.reject_reason ? line.reject_reason : "";
+	}
+	LineRow View() const {
+		return LineRow {line_number,
+		                data.data(),
+		                data.size(),
+		                byte_offset,
+		                match_id,
+		                reject_reason.empty() ? nullptr : reject_reason.c_str()};
+	}
+};
+
+// What the virtual file columns report for the current file. Pipes, and
+// files whose size or modification time cannot be read, have NULLs.
+struct LineFileMetadata {
+	idx_t index = 0; // Position in the bind's file list
+	bool has_size = false;
+	int64_t size = 0;
+	bool has_mtime = false;
+	timestamp_t mtime;
+};
+
+// Writes output rows into the projected vectors. Content-derived columns are
+// cut straight from the line's bytes: `content` (and `template`) are the only
+// ones that copy them into a string, so a scan that projects only
+// `content_hash` (or `fields`) never materializes the line.
+struct LineRowWriter {
+	LineTrimMode trim_mode = LineTrimMode::NONE;
+	string split_delimiter;
+	const LineTimestampParser *timestamp_parser = nullptr;
+	// Lines in the files before the current one, for global_line_number
+	int64_t line_base = 0;
+	LineFileMetadata file;
+	// List entry the current row is emitted for (spec_index); INVALID_INDEX
+	// writes NULL
+	idx_t spec_index = DConstants::INVALID_INDEX;
+	// Scratch for the current line's template, reused across rows
+	string template_buffer;
+
+	void Write(DataChunk &output, idx_t row, const vector<ReadLinesColumn> &projected, const LineRow &line,
+	           const string &file_path) {
+		if (line.reject_reason) {
+			WriteReject(output, row, projected, file_path, line.line_number, line.byte_offset, line.reject_reason);
+			return;
+		}
+		bool template_built = false;
+		for (idx_t col = 0; col < projected.size(); col++) {
+			auto &vec = output.data[col];
+			switch (projected[col]) {
+			case ReadLinesColumn::LINE_NUMBER:
+				FlatVector::GetData<int64_t>(vec)[row] = line.line_number;
+				break;
+			case ReadLinesColumn::GLOBAL_LINE_NUMBER:
+				FlatVector::GetData<int64_t>(vec)[row] = line_base + line.line_number;
+				break;
+			case ReadLinesColumn::SPEC_INDEX:
+				if (spec_index == DConstants::INVALID_INDEX) {
+					FlatVector::SetNull(vec, row, true);
+				} else {
+					FlatVector::GetData<int64_t>(vec)[row] = static_cast<int64_t>(spec_index);
+				}
+				break;
+			case ReadLinesColumn::CONTENT: {
+				idx_t begin = 0;
+				idx_t end = line.size;
+				LineTrimBounds(line.data, trim_mode, begin, end);
+				FlatVector::GetData<string_t>(vec)[row] = StringVector::AddString(vec, line.data + begin, end - begin);
+				break;
+			}
+			case ReadLinesColumn::BYTE_OFFSET:
+				FlatVector::GetData<int64_t>(vec)[row] = line.byte_offset;
+				break;
+			case ReadLinesColumn::FILE_PATH:
+				FlatVector::GetData<string_t>(vec)[row] = StringVector::AddString(vec, file_path);
+				break;
+			case ReadLinesColumn::FIELDS:
+				AppendLineFields(vec, row, line.data, line.size, trim_mode, split_delimiter);
+				break;
+			case ReadLinesColumn::CONTENT_HASH: {
+				// Hash of the trimmed content, computed on the buffer slice
+				idx_t begin = 0;
+				idx_t end = line.size;
+				LineTrimBounds(line.data, trim_mode, begin, end);
+				FlatVector::GetData<hash_t>(vec)[row] = Hash(line.data + begin, end - begin);
+				break;
+			}
+			case ReadLinesColumn::TEMPLATE:
+			case ReadLinesColumn::TEMPLATE_HASH:
+				if (!template_built) {
+					BuildTemplate(line);
+					template_built = true;
+				}
+				if (projected[col] == ReadLinesColumn::TEMPLATE) {
+					FlatVector::GetData<string_t>(vec)[row] = StringVector::AddString(vec, template_buffer);
+				} else {
+					FlatVector::GetData<hash_t>(vec)[row] = Hash(template_buffer.data(), template_buffer.size());
+				}
+				break;
+			case ReadLinesColumn::MATCH_ID:
+				// 1-based, like list positions; NULL for context lines
+				if (line.match_id == DConstants::INVALID_INDEX) {
+					FlatVector::SetNull(vec, row, true);
+				} else {
+					FlatVector::GetData<int32_t>(vec)[row] = static_cast<int32_t>(line.match_id + 1);
+				}
+				break;
+			case ReadLinesColumn::MATCH_COUNT:
+				break;
+			case ReadLinesColumn::REJECT_REASON:
+				FlatVector::SetNull(vec, row, true);
+				break;
+			case ReadLinesColumn::FILE_INDEX:
+				FlatVector::GetData<int64_t>(vec)[row] = static_cast<int64_t>(file.index);
+				break;
+			case ReadLinesColumn::FILE_SIZE:
+				if (file.has_size) {
+					FlatVector::GetData<int64_t>(vec)[row] = file.size;
+				} else {
+					FlatVector::SetNull(vec, row, true);
+				}
+				break;
+			case ReadLinesColumn::FILE_MTIME:
+				if (file.has_mtime) {
+					FlatVector::GetData<timestamp_t>(vec)[row] = file.mtime;
+				} else {
+					FlatVector::SetNull(vec, row, true);
+				}
+				break;
+			case ReadLinesColumn::LINE_TIMESTAMP:
+				// NULL when the line does not start with a timestamp
+				if (!timestamp_parser->Parse(line.data, line.size, FlatVector::GetData<timestamp_t>(vec)[row])) {
+					FlatVector::SetNull(vec, row, true);
+				}
+				break;
+			case ReadLinesColumn::NONE:
+				break;
+			}
+		}
+	}
+
+	// A row for a file or line that could not be read: its location (NULL
+	// where unknown) and reject_reason; every content column is NULL.
+	void WriteReject(DataChunk &output, idx_t row, const vector<ReadLinesColumn> &projected, const string &file_path,
+	                 int64_t line_number, int64_t byte_offset, const char *reason) {
+		for (idx_t col = 0; col < projected.size(); col++) {
+			auto &vec = output.data[col];
+			switch (projected[col]) {
+			case ReadLinesColumn::FILE_PATH:
+				FlatVector::GetData<string_t>(vec)[row] = StringVector::AddString(vec, file_path);
+				break;
+			case ReadLinesColumn::REJECT_REASON:
+				FlatVector::GetData<string_t>(vec)[row] = StringVector::AddString(vec, reason);
+				break;
+			case ReadLinesColumn::LINE_NUMBER:
+			case ReadLinesColumn::BYTE_OFFSET: {
+				auto value = projected[col] == ReadLinesColumn::LINE_NUMBER ? line_number : byte_offset;
+				if (value < 0) {
+					FlatVector::SetNull(vec, row, true);
+				} else {
+					FlatVector::GetData<int64_t>(vec)[row] = value;
+				}
+				break;
+			}
+			case ReadLinesColumn::NONE:
+				break;
+			default:
+				FlatVector::SetNull(vec, row, true);
+				break;
+			}
+		}
+	}
+
+private:
+	// Templates are built from the trimmed content without its terminator.
+	void BuildTemplate(const LineRow &line) {
+		idx_t begin = 0;
+		idx_t end = line.size;
+		LineTrimBounds(line.data, trim_mode, begin, end);
+		if (trim_mode == LineTrimMode::NONE || trim_mode == LineTrimMode::LEFT) {
+			LineTrimBounds(line.data, LineTrimMode::ENDINGS, begin, end);
+		}
+		BuildLineTemplate(line.data + begin, end - begin, template_buffer);
+	}
+};
+
+// A unit of parallel work: a file, or a range of one (a morsel) cut at the
+// blocks of its line index, which gives the line number the range starts at.
+// Morsels of a file without an index name a LineIndexPlan part instead, and
+// get their range once the plan's index is assembled.
+struct LineScanItem {
+	idx_t file = 0;                         // Position in the bind's file list
+	int64_t byte_start = 0;                 // Range start, a line start
+	int64_t byte_end = -1;                  // Range end; -1 for the whole file
+	int64_t first_line = 1;                 // Line number at byte_start
+	idx_t first_block = 0;                  // Block of `index` at byte_start
+	int64_t size = 0;                       // Bytes to read, when known; orders the work
+	idx_t plan = DConstants::INVALID_INDEX; // LineIndexPlan the morsel belongs to, if any
+	idx_t part = 0;                         // The morsel's part of the plan
+	bool count_part = false;                // Index the part rather than read it
+	shared_ptr<LineIndex> index;            // The index a range was cut from
+};
+
+// A large file without a line index, indexed in parts (one per morsel) by the
+// threads of a parallel scan before its morsels are read: the parts' line
+// counts, summed in file order, number each morsel's first line.
+struct LineIndexPlan {
+	string path;
+	FileIdentity identity;
+	int64_t morsel_bytes = 0;
+	idx_t parts_left = 0;
+	vector<vector<LineIndexBlock>> parts;
+	vector<idx_t> first_blocks;  // Each part's first block in the index
+	shared_ptr<LineIndex> index; // Set when every part is indexed
+	bool failed = false;         // A part could not be indexed: read the file whole
+	// Every part is in, and `index` or `failed` is set
+	std::atomic<bool> ready {false};
+	std::atomic<bool> whole_taken {false};
+	mutex lock;
+	std::condition_variable indexed;
+};
+
+// The work of a parallel scan: plan parts to index first, then files and
+// morsels largest first. Threads claim items as they become free, so a thread
+// done with a small file moves on to the next morsel of a big one. A morsel
+// whose plan is still being indexed is set aside and the next item claimed
+// instead; set-aside morsels are taken as their plans become ready, and only
+// waited for once nothing else is left.
+struct LineWorkQueue {
+	vector<LineScanItem> items;
+	vector<unique_ptr<LineIndexPlan>> plans;
+	std::atomic<idx_t> next {0};
+
+	bool Claim(FileSystem &fs, LineScanItem &item) {
+		while (true) {
+			if (TakeDeferred(item, true)) {
+				if (ResolvePlanPart(*plans[item.plan], item)) {
+					return true;
+				}
+				continue;
+			}
+			auto position = next.fetch_add(1);
+			if (position >= items.size()) {
+				break;
+			}
+			item = items[position];
+			if (item.plan == DConstants::INVALID_INDEX) {
+				return true;
+			}
+			auto &plan = *plans[item.plan];
+			if (item.count_part) {
+				IndexPlanPart(fs, plan, item.part);
+			} else if (!plan.ready) {
+				lock_guard<mutex> guard(deferred_lock);
+				deferred.push_back(item);
+			} else if (ResolvePlanPart(plan, item)) {
+				return true;
+			}
+		}
+		// Only morsels of plans other threads are still indexing are left
+		while (TakeDeferred(item, false)) {
+			if (ResolvePlanPart(*plans[item.plan], item)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	mutex deferred_lock;
+	vector<LineScanItem> deferred; // Morsels claimed before their plan was ready
+
+	// A set-aside morsel: the first whose plan is ready, or with `ready_only`
+	// false the first of any
+	bool TakeDeferred(LineScanItem &item, bool ready_only) {
+		lock_guard<mutex> guard(deferred_lock);
+		for (idx_t i = 0; i < deferred.size(); i++) {
+			if (!ready_only || plans[deferred[i].plan]->ready) {
+				item = std::move(deferred[i]);
+				deferred.erase(deferred.begin() + static_cast<int64_t>(i));
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static void IndexPlanPart(FileSystem &fs, LineIndexPlan &plan, idx_t part) {
+		vector<LineIndexBlock> blocks;
+		bool failed = false;
+		try {
+			auto handle = fs.OpenFile(plan.path, FileFlags::FILE_FLAGS_READ);
+			auto size = plan.identity.size;
+			auto morsel = static_cast<int64_t>(part) * plan.morsel_bytes;
+			auto start = LineIndex::NextLineStart(*handle, morsel, size);
+			auto end = LineIndex::NextLineStart(*handle, MinValue(morsel + plan.morsel_bytes, size), size);
+			blocks = LineIndex::IndexPart(*handle, start, end);
+		} catch (std::exception &) {
+			// Read whole; the scan reports the error
+			failed = true;
+		}
+		{
+			lock_guard<mutex> guard(plan.lock);
+			plan.parts[part] = std::move(blocks);
+			plan.failed = plan.failed || failed;
+			if (--plan.parts_left > 0) {
+				return;
+			}
+		}
+		// The last part: no other thread touches the parts until the plan is
+		// ready, so the index is assembled (file reads included) unlocked
+		shared_ptr<LineIndex> index;
+		if (!plan.failed) {
+			try {
+				auto handle = fs.OpenFile(plan.path, FileFlags::FILE_FLAGS_READ);
+				idx_t block = 0;
+				for (idx_t i = 0; i < plan.parts.size(); i++) {
+					plan.first_blocks[i] = block;
+					block += plan.parts[i].size();
+				}
+				index = LineIndex::Assemble(plan.path, *handle, plan.identity, std::move(plan.parts));
+				LineIndexCache::Get().Store(index);
+			} catch (std::exception &) {
+				index = nullptr;
+			}
+		}
+		{
+			lock_guard<mutex> guard(plan.lock);
+			plan.index = std::move(index);
+			plan.failed = !plan.index;
+			plan.ready = true;
+		}
+		plan.indexed.notify_all();
+	}
+
+	// Fill in a morsel's range from the plan's index, waiting for it; false
+	// when there is nothing to read (an empty part, or the plan failed and
+	// another morsel reads the file whole).
+	static bool ResolvePlanPart(LineIndexPlan &plan, LineScanItem &item) {
+		unique_lock<mutex> guard(plan.lock);
+		plan.indexed.wait(guard, [&]() { return plan.ready.load(); });
+		if (plan.failed) {
+			if (plan.whole_taken.exchange(true)) {
+				return false;
+			}
+			item.plan = DConstants::INVALID_INDEX;
+			return true;
+		}
+		auto &blocks = plan.index->blocks;
+		auto first = plan.first_blocks[item.part];
+		auto end = item.part + 1 < plan.first_blocks.size() ? plan.first_blocks[item.part + 1] : blocks.size();
+		if (first == end) {
+			return false;
+		}
+		item.byte_start = blocks[first].byte_start;
+		item.byte_end = end < blocks.size() ? blocks[end].byte_start : plan.identity.size;
+		item.first_line = blocks[first].first_line;
+		item.first_block = first;
+		item.index = plan.index;
+		return true;
+	}
+};
+
+// A pipe source ('cmd |' on shellfs) started ahead of the scan. One the scan
+// never took (it ended early) is abandoned: its command may stay quiet for a
+// long time, and the scan must not wait for it to write or exit.
+struct LaunchedPipe {
+	string path;
 	idx_t file_index;
+	unique_ptr<FileHandle> handle;
+	unique_ptr<ReadAheadSource> source; // Declared after handle: stops reading first
+	shared_ptr<AbandonedReaders> abandoned_readers;
+
+	LaunchedPipe() = default;
+	LaunchedPipe(LaunchedPipe &&other) = default;
+	LaunchedPipe &operator=(LaunchedPipe &&other) = default;
+	~LaunchedPipe() {
+		if (source && abandoned_readers) {
+			source->Abandon(handle, *abandoned_readers);
+		}
+	}
+};
+
+// A scan over a series of files: the whole scan on one thread, or, when it
+// runs in parallel, one thread's share of it (the files and ranges it claims
+// from a LineWorkQueue).
+struct ReadTextLinesScanState {
+	idx_t file_index;
+	// parallel := true: the queue work is claimed from, and the claimed item
+	// being read; otherwise item stays a whole file
+	shared_ptr<LineWorkQueue> work;
+	LineScanItem item;
 	unique_ptr<FileHandle> current_file;
+	unique_ptr<LineArchive> archive; // Archive whose members are being scanned
+	string archive_path;
+	unique_ptr<LineSource> source; // Decompressing reader of current_file, or an archive member
 	unique_ptr<BufferedLineReader> reader;
 	int64_t current_line_number;
 	string current_file_path;
 	bool file_finished;
+	// global_line_number: the current file's lines have yet to be added to
+	// writer.line_base; file_at_eof when it was read to the end, else
+	// file_total_lines if known (-1) from an index or a from-end count
+	bool counting_lines;
+	bool file_at_eof;
+	int64_t file_total_lines;
 	FileSystem *fs;
-	LineSelection resolved_selection; // Per-file resolved selection (handles from-end refs)
-
-	ReadTextLinesGlobalState()
-	    : file_index(0), current_line_number(0), file_finished(true), fs(nullptr),
-	      resolved_selection(LineSelection::All()) {
+	LineSelection resolved_selection;  // Per-file resolved selection (handles from-end refs)
+	vector<FileLineSpec> specs;        // Current file's list entries, in spec mode
+	vector<ReadLinesColumn> projected; // Column carried by each output vector
+	bool wants_file_stats;             // file_size or file_mtime is projected
+	LineRowWriter writer;
+	shared_ptr<LineIndex> line_index; // Current file's index, when blocks can be skipped
+	idx_t next_block;                 // First index block the reader has not entered yet
+	bool skip_by_trigrams;            // Which of the index's summaries apply
+	bool skip_by_time;
+	// match context, like grep -C: a ring of the last match_before lines that
+	// did not match (grown as lines arrive, so a large match_before costs
+	// only the lines actually held), the number of after-context lines still
+	// owed, and rows that did not fit the current chunk
+	vector<OwnedLineRow> before_ring;
+	idx_t ring_next;
+	idx_t ring_size;
+	int64_t after_remaining;
+	std::deque<OwnedLineRow> pending;
+	idx_t decompress_threads; // Parallel inflation bound for BGZF files
+	// Takes the read-ahead threads of sources left unfinished (see ~LaunchedPipe)
+	shared_ptr<AbandonedReaders> abandoned_readers;
+	// Pipes run their commands concurrently, up to max_pipes at a time, and
+	// are scanned in the order their output arrives
+	vector<LaunchedPipe> pipes;
+	vector<bool> launched; // Files started as pipes, skipped by file_index
+	idx_t pipe_cursor;     // Next file to consider launching
+	idx_t max_pipes;
+	shared_ptr<ReadySignal> pipe_signal;
+	// flush_interval: armed once the chunk holds min_batch rows
+	bool flush_armed;
+	std::chrono::steady_clock::time_point chunk_started; // First row of the chunk
+	std::chrono::steady_clock::time_point flush_deadline;
+	// rejects: (path, reason) of files that failed to open, still to be
+	// output; the path being opened; the reason a read failed mid-file
+	std::deque<std::pair<string, string>> file_rejects;
+	string opening_path;
+	string read_error;
+	// Small-window fast path: still to be tried; the handle it opened when
+	// it handed the file to the general path
+	bool small_window;
+	unique_ptr<FileHandle> prefetched_file;
+	// snapshot: the current file's size when it was opened; no pass reads
+	// past it (-1 when not pinned)
+	int64_t snapshot_end;
+
+	ReadTextLinesScanState()
+	    : file_index(0), current_line_number(0), file_finished(true), counting_lines(false), file_at_eof(false),
+	      file_total_lines(-1), fs(nullptr), resolved_selection(LineSelection::All()), wants_file_stats(false),
+	      next_block(0), skip_by_trigrams(false), skip_by_time(false),
+	      ring_next(0), ring_size(0), after_remaining(0), decompress_threads(1), pipe_cursor(0), max_pipes(1),
+	      pipe_signal(make_shared_ptr<ReadySignal>()), flush_armed(false), small_window(false),
+	      snapshot_end(-1) {
 	}
+	~ReadTextLinesScanState() {
+		// A scan that stopped early (LIMIT) may leave a pipe or stream whose
+		// command is quiet: let its read-ahead thread close it when it can
+		if (source && abandoned_readers) {
+			reader.reset();
+			source->Abandon(current_file, *abandoned_readers);
+		}
+	}
+};
+
+struct ReadTextLinesGlobalState : public GlobalTableFunctionState {
+	ReadTextLinesScanState scan; // The scan, unless it runs in parallel
+	shared_ptr<LineWorkQueue> work;
+	idx_t max_threads = 1;
+	// Paths that matched nothing are reported by the first thread only
+	std::atomic<bool> rejects_taken {false};
 
 	idx_t MaxThreads() const override {
-		return 1;
+		return max_threads;
 	}
 };
 
-static unique_ptr<FunctionData> ReadTextLinesBind(ClientContext &context, TableFunctionBindInput &input,
-                                                  vector<LogicalType> &return_types, vector<string> &names) {
-	auto &fs = FileSystem::GetFileSystem(context);
-	auto input_path = input.inputs[0].GetValue<string>();
+struct ReadTextLinesLocalState : public LocalTableFunctionState {
+	unique_ptr<ReadTextLinesScanState> scan; // This thread's scan, in parallel
+};
 
+// Glob one path argument. A path that matches nothing as written may carry
+// an embedded line spec ('file.py:10-20', returned in path_line_selection)
+// or lead into archives ('bundle.zip/**/*.log', returned in archive_members).
+static vector<OpenFileInfo> GlobInputPath(ClientContext &context, FileSystem &fs, const string &input_path,
+                                          LineSelection &path_line_selection, string &archive_members) {
 	// Try the original path first - if it exists or matches files, use it as-is
 	// This handles cases where filenames contain colons (e.g., "file:2.txt")
-	auto files = compat::GlobFilesCompat(fs, input_path, context, FileGlobOptions::ALLOW_EMPTY);
-
-	string glob_pattern = input_path;
-	LineSelection path_line_selection = LineSelection::All();
+	auto files = GlobLineFiles(context, fs, input_path);
 
+	auto parsed_result = LineSelection::ParsePathWithLineSpec(input_path);
 	if (files.empty()) {
 		// No files found with original path - try parsing for embedded line spec
-		auto parsed_result = LineSelection::ParsePathWithLineSpec(input_path);
 		if (parsed_result.first != input_path) {
 			// Path was parsed differently, try globbing with the extracted path
-			files = compat::GlobFilesCompat(fs, parsed_result.first, context, FileGlobOptions::ALLOW_EMPTY);
+			files = GlobLineFiles(context, fs, parsed_result.first);
 			if (!files.empty()) {
-				glob_pattern = parsed_result.first;
 				path_line_selection = std::move(parsed_result.second);
 			}
 		}
 	}
 
+	// Still nothing: the path may lead into archives ('bundle.zip/**/*.log').
+	// The archives are globbed here; their members are matched as they are read.
+	if (files.empty()) {
+		string archive;
+		if (SplitArchivePath(input_path, archive, archive_members)) {
+			files = GlobLineFiles(context, fs, archive);
+		}
+		if (files.empty() && parsed_result.first != input_path &&
+		    SplitArchivePath(parsed_result.first, archive, archive_members)) {
+			files = GlobLineFiles(context, fs, archive);
+			if (!files.empty()) {
+				path_line_selection = std::move(parsed_result.second);
+			}
+		}
+		if (files.empty()) {
+			archive_members.clear();
+		}
+	}
+	return files;
+}
+
+// A path list entry: its matches, and the line spec it carries, if any
+struct PathListEntry {
+	vector<OpenFileInfo> matches;
+	bool has_spec;
+	LineSelection selection;
+};
+
+// A {path, spec} entry of a path list; spec takes anything `lines` does, and
+// a NULL spec means the entry has none
+static void ParsePathStruct(const Value &entry, string &path, bool &has_spec, LineSelection &selection) {
+	auto &child_types = StructType::GetChildTypes(entry.type());
+	auto &children = StructValue::GetChildren(entry);
+	bool has_path = false;
+	for (idx_t i = 0; i < child_types.size(); i++) {
+		auto &name = child_types[i].first;
+		if (StringUtil::CIEquals(name, "path")) {
+			if (children[i].IsNull()) {
+				throw InvalidInputException("read_lines: paths must not be NULL");
+			}
+			path = children[i].GetValue<string>();
+			has_path = true;
+		} else if (StringUtil::CIEquals(name, "spec")) {
+			if (!children[i].IsNull()) {
+				selection = LineSelection::Parse(children[i]);
+				has_spec = true;
+			}
+		} else {
+			throw InvalidInputException("read_lines: path entries have only path and spec fields, not \"%s\"", name);
+		}
+	}
+	if (!has_path) {
+		throw InvalidInputException("read_lines: path entries need a path field");
+	}
+}
+
+// snapshot := true: the size of every regular file at bind, so that a scan
+// (and each of its passes and morsels) sees no line appended after the
+// query started, however late it opens the file. Commands, FIFOs, archives
+// and compressed files are read to the end of their stream instead.
+static void PinSnapshotSizes(FileSystem &fs, ReadTextLinesBindData &bind_data, FileCompressionType compression,
+                             bool archives) {
+	bind_data.snapshot_sizes.assign(bind_data.files.size(), -1);
+	if (archives) {
+		return;
+	}
+	for (idx_t i = 0; i < bind_data.files.size(); i++) {
+		auto &path = bind_data.files[i].path;
+		if (path.find('|') != string::npos ||
+		    ResolveLineCompression(compression, path) != FileCompressionType::UNCOMPRESSED || fs.IsPipe(path)) {
+			continue;
+		}
+		try {
+			auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+			if (handle && handle->CanSeek()) {
+				bind_data.snapshot_sizes[i] = static_cast<int64_t>(handle->GetFileSize());
+			}
+		} catch (std::exception &) {
+			// Reported, or skipped, when the scan opens it
+		}
+	}
+}
+
+static unique_ptr<FunctionData> ReadTextLinesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+	auto &fs = FileSystem::GetFileSystem(context);
+
+	vector<OpenFileInfo> files;
+	LineSelection path_line_selection = LineSelection::All();
+	string archive_members;
+	vector<string> unmatched_paths; // Path arguments that matched no files
+	auto &path_value = input.inputs[0];
+	vector<PathListEntry> list_entries;
+	bool has_entry_specs = false; // Some list entry carries its own line spec
+	if (path_value.type().id() == LogicalTypeId::LIST) {
+		// Several sources: each path is globbed as written, in list order
+		if (path_value.IsNull()) {
+			throw BinderException("read_lines: the list of paths must not be NULL");
+		}
+		auto &entries = ListValue::GetChildren(path_value);
+		for (idx_t i = 0; i < entries.size(); i++) {
+			auto &entry = entries[i];
+			if (entry.IsNull()) {
+				throw InvalidInputException("read_lines: paths must not be NULL");
+			}
+			PathListEntry list_entry {{}, false, LineSelection::All()};
+			string path;
+			if (entry.type().id() == LogicalTypeId::STRUCT) {
+				ParsePathStruct(entry, path, list_entry.has_spec, list_entry.selection);
+			} else {
+				path = entry.GetValue<string>();
+			}
+			list_entry.matches = GlobLineFiles(context, fs, path);
+			if (list_entry.matches.empty() && !list_entry.has_spec) {
+				// 'file.py:10-20' as an entry of its own
+				auto parsed = LineSelection::ParsePathWithLineSpec(path);
+				if (parsed.first != path) {
+					list_entry.matches = GlobLineFiles(context, fs, parsed.first);
+					if (!list_entry.matches.empty()) {
+						list_entry.has_spec = true;
+						list_entry.selection = std::move(parsed.second);
+					}
+				}
+			}
+			if (list_entry.matches.empty()) {
+				unmatched_paths.push_back(path);
+			}
+			has_entry_specs = has_entry_specs || list_entry.has_spec;
+			list_entries.push_back(std::move(list_entry));
+		}
+		if (!has_entry_specs) {
+			for (auto &list_entry : list_entries) {
+				for (auto &match : list_entry.matches) {
+					files.push_back(std::move(match));
+				}
+			}
+			list_entries.clear();
+		}
+	} else {
+		if (path_value.IsNull() || path_value.type().id() != LogicalTypeId::VARCHAR) {
+			throw InvalidInputException("read_lines: path must be a VARCHAR or a VARCHAR[] of paths");
+		}
+		auto input_path = path_value.GetValue<string>();
+		files = GlobInputPath(context, fs, input_path, path_line_selection, archive_members);
+		if (files.empty()) {
+			unmatched_paths.push_back(input_path);
+		}
+	}
+
 	LineSelection line_selection = LineSelection::All();
 	LineTrimMode trim_mode = LineTrimMode::NONE;
 	bool has_explicit_lines = false;
 	int64_t before_context = 0;
 	int64_t after_context = 0;
 	bool ignore_errors = false;
+	bool split = false;
+	string split_delimiter;
+	bool content_hash = false;
+	bool line_template = false;
+	string timestamp_format;
+	string match_pattern;
+	bool has_match = false;
+	vector<string> match_any;
+	bool has_match_any = false;
+	bool invert = false;
+	bool count_only = false;
+	auto compression = FileCompressionType::AUTO_DETECT;
+	int64_t flush_interval_us = -1;
+	int64_t min_batch = -1;
+	bool rejects = false;
+	bool global_line_number = false;
+	bool snapshot = false;
+	bool complete_lines = false;
+	bool parallel = false;
 
 	// Check for second positional argument (lines)
 	if (input.inputs.size() > 1 && !input.inputs[1].IsNull()) {
@@ -100,6 +926,8 @@ static unique_ptr<FunctionData> ReadTextLinesBind(ClientContext &context, TableF
 			has_explicit_lines = true;
 		} else if (name == "trim") {
 			trim_mode = ParseLineTrimMode(value);
+		} else if (name == "split") {
+			split = ParseSplitDelimiter(value, split_delimiter);
 		} else if (name == "before") {
 			before_context = value.GetValue<int64_t>();
 		} else if (name == "after") {
@@ -109,282 +937,1482 @@ static unique_ptr<FunctionData> ReadTextLinesBind(ClientContext &context, TableF
 			after_context = before_context;
 		} else if (name == "ignore_errors") {
 			ignore_errors = value.GetValue<bool>();
+		} else if (name == "rejects") {
+			rejects = !value.IsNull() && value.GetValue<bool>();
+		} else if (name == "content_hash") {
+			content_hash = !value.IsNull() && value.GetValue<bool>();
+		} else if (name == "global_line_number") {
+			global_line_number = !value.IsNull() && value.GetValue<bool>();
+		} else if (name == "snapshot") {
+			snapshot = !value.IsNull() && value.GetValue<bool>();
+		} else if (name == "complete_lines") {
+			complete_lines = !value.IsNull() && value.GetValue<bool>();
+		} else if (name == "parallel") {
+			parallel = !value.IsNull() && value.GetValue<bool>();
+		} else if (name == "template") {
+			line_template = !value.IsNull() && value.GetValue<bool>();
+		} else if (name == "timestamp_format") {
+			timestamp_format = value.GetValue<string>();
+		} else if (name == "match") {
+			has_match = !value.IsNull();
+			if (has_match) {
+				match_pattern = value.GetValue<string>();
+			}
+		} else if (name == "flush_interval") {
+			if (!value.IsNull()) {
+				flush_interval_us = Interval::GetMicro(value.GetValue<interval_t>());
+				if (flush_interval_us < 0) {
+					throw InvalidInputException("read_lines: flush_interval must not be negative");
+				}
+			}
+		} else if (name == "min_batch") {
+			min_batch = value.GetValue<int64_t>();
+			if (min_batch < 1 || min_batch > static_cast<int64_t>(STANDARD_VECTOR_SIZE)) {
+				throw InvalidInputException("read_lines: min_batch must be between 1 and %llu",
+				                            static_cast<uint64_t>(STANDARD_VECTOR_SIZE));
+			}
+		} else if (name == "compression") {
+			compression = FileCompressionTypeFromString(value.GetValue<string>());
+		} else if (name == "invert") {
+			invert = !value.IsNull() && value.GetValue<bool>();
+		} else if (name == "count_only") {
+			count_only = !value.IsNull() && value.GetValue<bool>();
+		} else if (name == "match_any") {
+			has_match_any = !value.IsNull();
+			if (has_match_any) {
+				for (auto &pattern : ListValue::GetChildren(value)) {
+					if (pattern.IsNull()) {
+						throw InvalidInputException("match_any patterns must not be NULL");
+					}
+					match_any.push_back(pattern.GetValue<string>());
+				}
+			}
+		}
+	}
+
+	// If no explicit lines param, use path-embedded selection
+	if (!has_explicit_lines && !path_line_selection.IsAll()) {
+		line_selection = std::move(path_line_selection);
+	}
+
+	if (rejects && count_only) {
+		throw InvalidInputException("read_lines: rejects cannot be combined with count_only");
+	}
+	// Rejects are reported instead of raised
+	ignore_errors = ignore_errors || rejects;
+	if (min_batch >= 0 && flush_interval_us < 0) {
+		throw InvalidInputException("read_lines: min_batch requires flush_interval");
+	}
+	if (has_match && has_match_any) {
+		throw InvalidInputException("read_lines: match and match_any cannot be combined");
+	}
+	if (invert && !has_match && !has_match_any) {
+		throw InvalidInputException("read_lines: invert requires match or match_any");
+	}
+	if (count_only && (split || content_hash || line_template || !timestamp_format.empty() || global_line_number)) {
+		throw InvalidInputException("read_lines: count_only returns only file_path and match_count; split, "
+		                            "content_hash, template, timestamp_format and global_line_number do not apply");
+	}
+
+	// With match, context surrounds matching lines rather than the selection
+	if (!has_match && !has_match_any && (before_context > 0 || after_context > 0)) {
+		line_selection.AddContext(before_context, after_context);
+	}
+
+	if (!unmatched_paths.empty() && !ignore_errors) {
+		throw IOException("No files found that match the pattern \"%s\"", unmatched_paths[0]);
+	}
+
+	// Per-entry line specs: each distinct file is read once, for all the
+	// entries that name it. Pipes are commands, so each entry runs its own.
+	vector<vector<FileLineSpec>> file_specs;
+	if (has_entry_specs) {
+		if (has_match || has_match_any || count_only) {
+			throw InvalidInputException(
+			    "read_lines: per-path line specs cannot be combined with match, match_any or count_only");
+		}
+		unordered_map<string, idx_t> file_positions;
+		for (idx_t i = 0; i < list_entries.size(); i++) {
+			auto &list_entry = list_entries[i];
+			auto selection = list_entry.has_spec ? std::move(list_entry.selection) : line_selection;
+			if (list_entry.has_spec && (before_context > 0 || after_context > 0)) {
+				selection.AddContext(before_context, after_context);
+			}
+			for (auto &match : list_entry.matches) {
+				idx_t position = files.size();
+				auto existing = file_positions.find(match.path);
+				if (existing != file_positions.end()) {
+					position = existing->second;
+				} else {
+					if (match.path.find('|') == string::npos) {
+						file_positions[match.path] = position;
+					}
+					files.push_back(std::move(match));
+					file_specs.emplace_back();
+				}
+				file_specs[position].push_back(FileLineSpec {i, selection});
+			}
+		}
+	}
+
+	auto result =
+	    make_uniq<ReadTextLinesBindData>(std::move(files), std::move(line_selection), trim_mode, ignore_errors);
+	result->snapshot = snapshot;
+	result->complete_lines = complete_lines;
+	if (snapshot) {
+		PinSnapshotSizes(fs, *result, compression, !archive_members.empty());
+	}
+	result->parallel = parallel;
+	if (count_only) {
+		result->columns = {ReadLinesColumn::FILE_PATH, ReadLinesColumn::MATCH_COUNT};
+	} else {
+		result->columns = {ReadLinesColumn::LINE_NUMBER, ReadLinesColumn::CONTENT, ReadLinesColumn::BYTE_OFFSET,
+		                   ReadLinesColumn::FILE_PATH};
+	}
+	if (split) {
+		result->columns.push_back(ReadLinesColumn::FIELDS);
+		result->split_delimiter = std::move(split_delimiter);
+	}
+	if (content_hash) {
+		result->columns.push_back(ReadLinesColumn::CONTENT_HASH);
+	}
+	if (global_line_number) {
+		result->columns.push_back(ReadLinesColumn::GLOBAL_LINE_NUMBER);
+		result->global_line_number = true;
+	}
+	if (has_entry_specs) {
+		result->columns.push_back(ReadLinesColumn::SPEC_INDEX);
+		result->file_specs = std::move(file_specs);
+	}
+	if (line_template) {
+		result->columns.push_back(ReadLinesColumn::TEMPLATE);
+		result->columns.push_back(ReadLinesColumn::TEMPLATE_HASH);
+	}
+	if (rejects) {
+		result->columns.push_back(ReadLinesColumn::REJECT_REASON);
+		result->rejects = true;
+		result->unmatched_paths = std::move(unmatched_paths);
+	}
+	if (!timestamp_format.empty()) {
+		result->columns.push_back(ReadLinesColumn::LINE_TIMESTAMP);
+		result->timestamp_parser = make_shared_ptr<LineTimestampParser>(std::move(timestamp_format));
+	}
+	if (has_match || has_match_any) {
+		if (has_match_any && !count_only) {
+			result->columns.push_back(ReadLinesColumn::MATCH_ID);
+		}
+		result->matcher =
+		    make_shared_ptr<LineMatcher>(has_match ? vector<string> {match_pattern} : std::move(match_any));
+		result->invert = invert;
+		// Counts ignore context
+		if (!count_only) {
+			result->match_before = MaxValue<int64_t>(before_context, 0);
+			result->match_after = MaxValue<int64_t>(after_context, 0);
+		}
+		// When only matching lines count, a match literal can also skip
+		// indexed blocks (context may reach across a block edge)
+		if (has_match && !invert && result->match_before == 0 && result->match_after == 0) {
+			result->required_substrings.push_back(std::move(match_pattern));
+		}
+	}
+	result->count_only = count_only;
+	result->compression = compression;
+	result->archive_members = std::move(archive_members);
+	result->flush_interval_us = flush_interval_us;
+	if (min_batch > 0) {
+		result->min_batch = static_cast<idx_t>(min_batch);
+	}
+	AddReadLinesColumns(result->columns, return_types, names);
+	return std::move(result);
+}
+
+static virtual_column_map_t ReadTextLinesGetVirtualColumns(ClientContext &context,
+                                                           optional_ptr<FunctionData> bind_data) {
+	virtual_column_map_t result;
+	result.insert(make_pair(COLUMN_IDENTIFIER_LINES_FILE_INDEX, TableColumn("file_index", LogicalType::BIGINT)));
+	result.insert(make_pair(COLUMN_IDENTIFIER_LINES_FILE_SIZE, TableColumn("file_size", LogicalType::BIGINT)));
+	result.insert(make_pair(COLUMN_IDENTIFIER_LINES_FILE_MTIME, TableColumn("file_mtime", LogicalType::TIMESTAMP)));
+	result.insert(make_pair(COLUMN_IDENTIFIER_EMPTY, TableColumn("", LogicalType::BOOLEAN)));
+	return result;
+}
+
+// Whether a parallel := true scan can run on several threads. Pipes,
+// global_line_number and flush_interval depend on one reader seeing every
+// source in turn, so they keep the scan on one thread.
+static bool IsParallelScan(const ReadTextLinesBindData &bind_data) {
+	if (bind_data.global_line_number || bind_data.flush_interval_us >= 0) {
+		return false;
+	}
+	for (auto &file : bind_data.files) {
+		if (file.path.find('|') != string::npos) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Whether files may be cut into ranges: each range is read as a file of its
+// own, so nothing may depend on the lines before or after it (match context,
+// from-end references, per-file counts and per-entry specs).
+static bool CanSplitFiles(const ReadTextLinesBindData &bind_data) {
+	return !bind_data.count_only && bind_data.file_specs.empty() && bind_data.archive_members.empty() &&
+	       bind_data.match_before == 0 && bind_data.match_after == 0 &&
+	       !bind_data.line_selection.HasFromEndReferences();
+}
+
+// Size of a file from the glob listing, when the file system reports it
+// (extended info); -1 when unknown. Nothing is opened.
+static int64_t ListedFileSize(const OpenFileInfo &file) {
+	if (file.extended_info) {
+		auto &options = file.extended_info->options;
+		auto size = options.find("file_size");
+		if (size != options.end() && !size->second.IsNull()) {
+			try {
+				return size->second.GetValue<int64_t>();
+			} catch (std::exception &) {
+			}
+		}
+	}
+	return -1;
+}
+
+// Bytes per morsel of a split file: about four per thread, so threads that
+// finish early have work left to claim, within [1 MiB, 32 MiB].
+static int64_t MorselBytes(int64_t size, idx_t threads) {
+	static constexpr int64_t MIN_MORSEL_BYTES = 1 << 20;
+	static constexpr int64_t MAX_MORSEL_BYTES = 32 << 20;
+	auto target = size / static_cast<int64_t>(threads * 4);
+	return MinValue(MaxValue(target, MIN_MORSEL_BYTES), MAX_MORSEL_BYTES);
+}
+
+// Cut an indexed file into morsels of about `morsel_bytes`, at block
+// boundaries, where the index gives each morsel's first line number.
+static void SplitIndexedFile(idx_t file, const shared_ptr<LineIndex> &index, int64_t morsel_bytes,
+                             vector<LineScanItem> &items) {
+	auto &blocks = index->blocks;
+	idx_t first = 0;
+	for (idx_t block = 1; block <= blocks.size(); block++) {
+		auto end = block < blocks.size() ? blocks[block].byte_start : index->identity.size;
+		if (block < blocks.size() && end - blocks[first].byte_start < morsel_bytes) {
+			continue;
+		}
+		LineScanItem item;
+		item.file = file;
+		item.byte_start = blocks[first].byte_start;
+		item.byte_end = end;
+		item.first_line = blocks[first].first_line;
+		item.first_block = first;
+		item.index = index;
+		item.size = end - item.byte_start;
+		items.push_back(item);
+		first = block;
+	}
+}
+
+// Plan the parallel indexing of a file without an index: one part to index,
+// and one morsel to read, per `morsel_bytes` of it.
+static void PlanUnindexedFile(idx_t file, const string &path, const FileIdentity &identity, int64_t morsel_bytes,
+                              LineWorkQueue &work, vector<LineScanItem> &count_items, vector<LineScanItem> &items) {
+	auto plan = make_uniq<LineIndexPlan>();
+	plan->path = path;
+	plan->identity = identity;
+	plan->morsel_bytes = morsel_bytes;
+	plan->parts_left = static_cast<idx_t>((identity.size + morsel_bytes - 1) / morsel_bytes);
+	plan->parts.resize(plan->parts_left);
+	plan->first_blocks.resize(plan->parts_left, 0);
+	for (idx_t part = 0; part < plan->parts_left; part++) {
+		LineScanItem item;
+		item.file = file;
+		item.plan = work.plans.size();
+		item.part = part;
+		item.size = MinValue<int64_t>(morsel_bytes, identity.size - static_cast<int64_t>(part) * morsel_bytes);
+		items.push_back(item);
+		item.count_part = true;
+		count_items.push_back(item);
+	}
+	work.plans.push_back(std::move(plan));
+}
+
+// The work of a parallel scan: every file whole, except that a file of at
+// least SPLIT_MIN_BYTES is cut into morsels, so one big file does not leave a
+// single thread reading it after the others finish. A file with a line index
+// of its current version (cached, a sidecar, or extended from one) is cut at
+// its blocks; any other is first indexed in parts, in parallel, so that every
+// morsel's first line number is exact. Largest first, so the small files fill
+// in at the end.
+//
+// Only a file that may be cut is opened here, once, for its size, identity
+// and index; the others are ordered by their listed size, and files whose
+// size the listing did not report go last, in file order.
+static void PlanParallelScan(FileSystem &fs, const ReadTextLinesBindData &bind_data, idx_t threads,
+                             LineWorkQueue &work) {
+	static constexpr int64_t SPLIT_MIN_BYTES = 8 << 20;
+	vector<LineScanItem> count_items;
+	vector<LineScanItem> items;
+	vector<LineScanItem> unsized_items;
+	bool split = CanSplitFiles(bind_data);
+	for (idx_t i = 0; i < bind_data.files.size(); i++) {
+		auto &file = bind_data.files[i];
+		auto size = ListedFileSize(file);
+		if (split && (size < 0 || size >= SPLIT_MIN_BYTES) &&
+		    ResolveLineCompression(bind_data.compression, file.path) == FileCompressionType::UNCOMPRESSED) {
+			try {
+				auto handle = fs.OpenFile(file.path, FileFlags::FILE_FLAGS_READ);
+				FileIdentity identity;
+				if (GetFileIdentity(*handle, identity)) {
+					size = identity.size;
+					if (size >= SPLIT_MIN_BYTES) {
+						auto morsel_bytes = MorselBytes(identity.size, threads);
+						auto index = LineIndex::Find(fs, file.path, *handle, identity);
+						if (index && index->blocks.size() > 1) {
+							SplitIndexedFile(i, index, morsel_bytes, items);
+							continue;
+						}
+						if (!index && identity.size > morsel_bytes) {
+							PlanUnindexedFile(i, file.path, identity, morsel_bytes, work, count_items, items);
+							continue;
+						}
+					}
+				}
+			} catch (std::exception &) {
+				// Read whole; the scan reports the error
+			}
+		}
+		LineScanItem item;
+		item.file = i;
+		if (size < 0) {
+			unsized_items.push_back(item);
+			continue;
+		}
+		item.size = size;
+		items.push_back(item);
+	}
+	std::stable_sort(items.begin(), items.end(),
+	                 [](const LineScanItem &a, const LineScanItem &b) { return a.size > b.size; });
+	work.items = std::move(count_items);
+	work.items.insert(work.items.end(), items.begin(), items.end());
+	work.items.insert(work.items.end(), unsized_items.begin(), unsized_items.end());
+}
+
+// read_lines('file.py:42 +/-5'): a single plain file and a window of at most
+// one chunk of lines, with nothing that needs the general scan's state
+// (matching, rejects, streaming).
+static bool IsSmallWindowScan(const ReadTextLinesBindData &bind_data) {
+	auto &selection = bind_data.line_selection;
+	if (bind_data.files.size() != 1 || !bind_data.archive_members.empty() || bind_data.matcher ||
+	    !bind_data.file_specs.empty() || bind_data.rejects || bind_data.snapshot || bind_data.complete_lines ||
+	    bind_data.flush_interval_us >= 0 || selection.IsAll() || selection.HasFromEndReferences() ||
+	    selection.MaxLine() - selection.MinLine() >= static_cast<int64_t>(STANDARD_VECTOR_SIZE)) {
+		return false;
+	}
+	auto &path = bind_data.files[0].path;
+	return path.find('|') == string::npos &&
+	       ResolveLineCompression(bind_data.compression, path) == FileCompressionType::UNCOMPRESSED;
+}
+
+// Set up a scan for the projected columns
+static void InitScanState(ClientContext &context, TableFunctionInitInput &input, ReadTextLinesScanState &scan) {
+	auto &bind_data = input.bind_data->Cast<ReadTextLinesBindData>();
+	auto result = &scan;
+	result->fs = &FileSystem::GetFileSystem(context);
+	result->abandoned_readers = AbandonedReaders::Get(context);
+	for (auto column_id : input.column_ids) {
+		auto column = ReadLinesColumn::NONE;
+		if (column_id < bind_data.columns.size()) {
+			column = bind_data.columns[column_id];
+		} else if (column_id == COLUMN_IDENTIFIER_LINES_FILE_INDEX) {
+			column = ReadLinesColumn::FILE_INDEX;
+		} else if (column_id == COLUMN_IDENTIFIER_LINES_FILE_SIZE) {
+			column = ReadLinesColumn::FILE_SIZE;
+		} else if (column_id == COLUMN_IDENTIFIER_LINES_FILE_MTIME) {
+			column = ReadLinesColumn::FILE_MTIME;
+		}
+		if (column == ReadLinesColumn::FILE_SIZE || column == ReadLinesColumn::FILE_MTIME) {
+			result->wants_file_stats = true;
+		}
+		result->projected.push_back(column);
+	}
+	result->writer.trim_mode = bind_data.trim_mode;
+	result->writer.split_delimiter = bind_data.split_delimiter;
+	result->writer.timestamp_parser = bind_data.timestamp_parser.get();
+	result->decompress_threads = static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+	result->max_pipes = MaxValue<idx_t>(result->decompress_threads, 2);
+	result->launched.resize(bind_data.files.size(), false);
+	for (auto &path : bind_data.unmatched_paths) {
+		result->file_rejects.emplace_back(path,
+		                                  StringUtil::Format("No files found that match the pattern \"%s\"", path));
+	}
+}
+
+static unique_ptr<GlobalTableFunctionState> ReadTextLinesInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<ReadTextLinesBindData>();
+	auto result = make_uniq<ReadTextLinesGlobalState>();
+	InitScanState(context, input, result->scan);
+	if (bind_data.parallel && IsParallelScan(bind_data)) {
+		auto threads = static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+		auto work = make_shared_ptr<LineWorkQueue>();
+		PlanParallelScan(*result->scan.fs, bind_data, threads, *work);
+		if (work->items.size() > 1 && threads > 1) {
+			result->work = std::move(work);
+			result->max_threads = MinValue(threads, result->work->items.size());
+			return std::move(result);
+		}
+	}
+	result->scan.small_window = IsSmallWindowScan(bind_data);
+	return std::move(result);
+}
+
+static unique_ptr<LocalTableFunctionState> ReadTextLinesLocalInit(ExecutionContext &context,
+                                                                  TableFunctionInitInput &input,
+                                                                  GlobalTableFunctionState *global_state_p) {
+	auto &global_state = global_state_p->Cast<ReadTextLinesGlobalState>();
+	auto result = make_uniq<ReadTextLinesLocalState>();
+	if (global_state.work) {
+		result->scan = make_uniq<ReadTextLinesScanState>();
+		InitScanState(context.client, input, *result->scan);
+		result->scan->work = global_state.work;
+		// Inflation threads are shared out between the scanning threads
+		auto &decompress_threads = result->scan->decompress_threads;
+		decompress_threads = MaxValue<idx_t>(decompress_threads / global_state.max_threads, 1);
+		if (global_state.rejects_taken.exchange(true)) {
+			result->scan->file_rejects.clear();
+		}
+	}
+	return std::move(result);
+}
+
+// Literal substrings a LIKE pattern's matches must contain: the runs between
+// wildcards. Without an ESCAPE clause '%' and '_' are always wildcards.
+static void AddLikeLiterals(const string &pattern, vector<string> &result) {
+	string literal;
+	for (auto c : pattern) {
+		if (c == '%' || c == '_') {
+			if (!literal.empty()) {
+				result.push_back(std::move(literal));
+				literal.clear();
+			}
+			continue;
+		}
+		literal += c;
+	}
+	if (!literal.empty()) {
+		result.push_back(std::move(literal));
+	}
+}
+
+static bool IsBoundColumn(LogicalGet &get, const ReadTextLinesBindData &bind_data, const Expression &expr,
+                          ReadLinesColumn column) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+		return false;
+	}
+	auto &binding = expr.Cast<BoundColumnRefExpression>().binding;
+	auto &column_ids = get.GetColumnIds();
+	if (binding.table_index != get.table_index || binding.column_index >= column_ids.size()) {
+		return false;
+	}
+	auto column_id = column_ids[binding.column_index].GetPrimaryIndex();
+	return column_id < bind_data.columns.size() && bind_data.columns[column_id] == column;
+}
+
+static bool GetTimestampConstant(const Expression &expr, timestamp_t &result) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	auto &value = expr.Cast<BoundConstantExpression>().value;
+	if (value.IsNull() || value.type().id() != LogicalTypeId::TIMESTAMP) {
+		return false;
+	}
+	result = value.GetValue<timestamp_t>();
+	return true;
+}
+
+// Narrow the pushed-down line_timestamp range by `column <type> constant`.
+// Strict bounds are kept inclusive: the range only decides which blocks to
+// read, never which rows qualify.
+static void NarrowTimeRange(ReadTextLinesBindData &bind_data, ExpressionType type, timestamp_t value) {
+	switch (type) {
+	case ExpressionType::COMPARE_EQUAL:
+		bind_data.time_lower = MaxValue(bind_data.time_lower, value);
+		bind_data.time_upper = MinValue(bind_data.time_upper, value);
+		break;
+	case ExpressionType::COMPARE_GREATERTHAN:
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		bind_data.time_lower = MaxValue(bind_data.time_lower, value);
+		break;
+	case ExpressionType::COMPARE_LESSTHAN:
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		bind_data.time_upper = MinValue(bind_data.time_upper, value);
+		break;
+	default:
+		return;
+	}
+	bind_data.has_time_filter = true;
+}
+
+static ExpressionType FlipComparison(ExpressionType type) {
+	switch (type) {
+	case ExpressionType::COMPARE_GREATERTHAN:
+		return ExpressionType::COMPARE_LESSTHAN;
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+	case ExpressionType::COMPARE_LESSTHAN:
+		return ExpressionType::COMPARE_GREATERTHAN;
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+	default:
+		return type;
+	}
+}
+
+static bool GetVarcharConstant(const Expression &expr, string &result) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	auto &value = expr.Cast<BoundConstantExpression>().value;
+	if (value.IsNull() || value.type().id() != LogicalTypeId::VARCHAR) {
+		return false;
+	}
+	result = value.GetValue<string>();
+	return true;
+}
+
+// Collect the literals that pushed-down content filters (contains, LIKE and
+// its prefix/suffix rewrites, equality) require, and the range that
+// comparisons on line_timestamp allow. The filters themselves stay in place,
+// so DuckDB still evaluates them exactly; the hints only let the scan skip
+// index blocks whose trigrams or timestamp range rule every line out.
+static void ReadTextLinesPushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                               vector<unique_ptr<Expression>> &filters) {
+	auto &bind_data = bind_data_p->Cast<ReadTextLinesBindData>();
+	for (auto &filter : filters) {
+		string literal;
+		if (filter->GetExpressionClass() == ExpressionClass::BOUND_FUNCTION) {
+			auto &func = filter->Cast<BoundFunctionExpression>();
+			auto &name = func.function.name;
+			if (func.children.size() != 2 ||
+			    !IsBoundColumn(get, bind_data, *func.children[0], ReadLinesColumn::CONTENT) ||
+			    !GetVarcharConstant(*func.children[1], literal)) {
+				continue;
+			}
+			if (name == "contains" || name == "prefix" || name == "suffix") {
+				bind_data.required_substrings.push_back(std::move(literal));
+			} else if (name == "~~") {
+				AddLikeLiterals(literal, bind_data.required_substrings);
+			}
+		} else if (filter->GetExpressionClass() == ExpressionClass::BOUND_COMPARISON) {
+			auto &comparison = filter->Cast<BoundComparisonExpression>();
+			auto type = filter->GetExpressionType();
+			timestamp_t time;
+			if (type == ExpressionType::COMPARE_EQUAL &&
+			    IsBoundColumn(get, bind_data, *comparison.left, ReadLinesColumn::CONTENT) &&
+			    GetVarcharConstant(*comparison.right, literal)) {
+				bind_data.required_substrings.push_back(std::move(literal));
+			} else if (IsBoundColumn(get, bind_data, *comparison.left, ReadLinesColumn::LINE_TIMESTAMP) &&
+			           GetTimestampConstant(*comparison.right, time)) {
+				NarrowTimeRange(bind_data, type, time);
+			} else if (IsBoundColumn(get, bind_data, *comparison.right, ReadLinesColumn::LINE_TIMESTAMP) &&
+			           GetTimestampConstant(*comparison.left, time)) {
+				NarrowTimeRange(bind_data, FlipComparison(type), time);
+			}
+		} else if (filter->GetExpressionClass() == ExpressionClass::BOUND_BETWEEN) {
+			auto &between = filter->Cast<BoundBetweenExpression>();
+			timestamp_t lower, upper;
+			if (IsBoundColumn(get, bind_data, *between.input, ReadLinesColumn::LINE_TIMESTAMP) &&
+			    GetTimestampConstant(*between.lower, lower) && GetTimestampConstant(*between.upper, upper)) {
+				NarrowTimeRange(bind_data, ExpressionType::COMPARE_GREATERTHANOREQUALTO, lower);
+				NarrowTimeRange(bind_data, ExpressionType::COMPARE_LESSTHANOREQUALTO, upper);
+			}
 		}
 	}
+}
 
-	// If no explicit lines param, use path-embedded selection
-	if (!has_explicit_lines && !path_line_selection.IsAll()) {
-		line_selection = std::move(path_line_selection);
+// Count total lines by scanning the stream through a reader (for resolving
+// from-end references on seekable sources; the caller rewinds afterwards).
+static int64_t CountLinesInStream(BufferedLineReader &reader) {
+	const char *line;
+	idx_t line_size;
+	int64_t offset;
+	int64_t count = 0;
+	while (reader.NextLine(line, line_size, offset)) {
+		count++;
 	}
+	return count;
+}
 
-	if (before_context > 0 || after_context > 0) {
-		line_selection.AddContext(before_context, after_context);
+// Whether index block `block` may hold a line passing the pushed-down filters.
+static bool IsCandidateBlock(const ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                             idx_t block) {
+	auto &index = *state.line_index;
+	if (state.skip_by_trigrams && !index.BlockMayContain(block, bind_data.required_substrings)) {
+		return false;
 	}
+	if (state.skip_by_time && !index.BlockMayOverlap(block, bind_data.time_lower, bind_data.time_upper)) {
+		return false;
+	}
+	return true;
+}
 
-	return_types.push_back(LogicalType::BIGINT);
-	names.push_back("line_number");
-
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("content");
+// Replace the reader with one over state.current_file from `start_offset`,
+// where the file is already positioned, within the file's snapshot.
+static void ResetFileReader(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                            int64_t start_offset) {
+	state.reader = make_uniq<BufferedLineReader>(*state.current_file, start_offset);
+	state.reader->SetSnapshot(state.snapshot_end, bind_data.complete_lines);
+}
 
-	return_types.push_back(LogicalType::BIGINT);
-	names.push_back("byte_offset");
+// Reposition the reader at the first index block from `block` on that may
+// hold a matching line. Returns false when no remaining block can.
+static bool SeekToCandidateBlock(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                                 idx_t block) {
+	auto &index = *state.line_index;
+	while (block < index.blocks.size() && !IsCandidateBlock(state, bind_data, block)) {
+		block++;
+	}
+	if (block >= index.blocks.size()) {
+		return false;
+	}
+	if (block != state.next_block) {
+		auto &target = index.blocks[block];
+		state.current_file->Seek(static_cast<idx_t>(target.byte_start));
+		ResetFileReader(state, bind_data, target.byte_start);
+		state.current_line_number = target.first_line - 1;
+	}
+	state.next_block = block;
+	return true;
+}
 
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("file_path");
+// The current file's index, for from-end references: its line count resolves
+// them, and its blocks let the scan seek to the first selected line instead
+// of reading up to it. Kept in the index cache per file version and extended
+// as the file is appended to, so a repeated tail of a growing log reads only
+// the new bytes and the block holding the window. Null when the lines must be
+// counted instead (complete_lines drops a line the index counts, and a
+// snapshot the file has already outgrown). An index of the file's current
+// size and time is only trusted once settled: if the file was modified in the
+// second it was indexed, it is counted again.
+static shared_ptr<LineIndex> FromEndIndex(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data) {
+	if (bind_data.complete_lines) {
+		return nullptr;
+	}
+	if (state.line_index) {
+		return state.line_index;
+	}
+	FileIdentity identity;
+	if (!GetFileIdentity(*state.current_file, identity) ||
+	    (state.snapshot_end >= 0 && identity.size != state.snapshot_end)) {
+		return nullptr;
+	}
+	auto index = LineIndex::Find(*state.fs, state.current_file_path, *state.current_file, identity, true);
+	if (!index) {
+		// Counting reads the whole file anyway; keep the offsets it passes
+		index = LineIndex::Build(state.current_file_path, *state.current_file, identity, false, nullptr);
+		LineIndexCache::Get().Store(index);
+	}
+	state.current_file->Seek(0);
+	ResetFileReader(state, bind_data, 0);
+	return index;
+}
 
-	if (files.empty() && !ignore_errors) {
-		throw IOException("No files found that match the pattern \"%s\"", input_path);
+// Move the reader to the start of the block of `index` holding `line`, when
+// that skips lines. The block becomes the next one entered if the index is
+// also the one skipping blocks.
+static void SeekToIndexedLine(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                              const LineIndex &index, int64_t line) {
+	auto &blocks = index.blocks;
+	auto next = std::upper_bound(blocks.begin(), blocks.end(), line,
+	                             [](int64_t line, const LineIndexBlock &block) { return line < block.first_line; });
+	if (next == blocks.begin() || next - 1 == blocks.begin()) {
+		return;
 	}
+	auto block = static_cast<idx_t>(next - 1 - blocks.begin());
+	auto &target = blocks[block];
+	state.current_file->Seek(static_cast<idx_t>(target.byte_start));
+	ResetFileReader(state, bind_data, target.byte_start);
+	state.current_line_number = target.first_line - 1;
+	if (state.line_index.get() == &index) {
+		state.next_block = block;
+	}
+}
 
-	return make_uniq<ReadTextLinesBindData>(std::move(files), std::move(line_selection), trim_mode, ignore_errors);
+// Called for each line read from an indexed file. Returns true when the line
+// should be processed; false when it opened a block that cannot match, in
+// which case the reader has been moved past it (or the file finished).
+static bool EnterIndexedBlock(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                              int64_t byte_offset) {
+	auto &blocks = state.line_index->blocks;
+	if (state.next_block >= blocks.size() || byte_offset < blocks[state.next_block].byte_start) {
+		return true;
+	}
+	// Blocks start at line boundaries, so this line is the block's first.
+	auto block = state.next_block;
+	if (IsCandidateBlock(state, bind_data, block)) {
+		state.next_block++;
+		return true;
+	}
+	if (!SeekToCandidateBlock(state, bind_data, block + 1)) {
+		state.file_finished = true;
+	}
+	return false;
 }
 
-static unique_ptr<GlobalTableFunctionState> ReadTextLinesInit(ClientContext &context, TableFunctionInitInput &input) {
-	auto result = make_uniq<ReadTextLinesGlobalState>();
-	result->fs = &FileSystem::GetFileSystem(context);
-	return std::move(result);
+// Whether `path` is a shellfs command whose output is read ('cmd |'), run
+// ahead of the scan alongside other such sources.
+static bool IsConcurrentPipe(const ReadTextLinesBindData &bind_data, const string &path) {
+	auto end = path.find_last_not_of(" \t");
+	return end != string::npos && path[end] == '|' && bind_data.archive_members.empty() &&
+	       ResolveLineCompression(bind_data.compression, path) == FileCompressionType::UNCOMPRESSED;
 }
 
-// =============================================================================
-// BufferedLineReader
-//
-// The single reading path for every source, seekable or not. Reads the source
-// in large chunks (one FileHandle::Read call per chunk instead of the previous
-// syscall-per-byte ReadLine loop) and splits lines with the shared ExtractLine,
-// so files, pipes, and parse_lines all agree on the same bytes:
-//   - terminators (\n, \r\n, lone \r) are separators AND are preserved in the
-//     returned content, as the README documents;
-//   - a terminator-final stream does not grow a phantom trailing line, and a
-//     trailing empty line ("a\n\n") is not silently dropped;
-//   - a UTF-8 BOM at the start of the stream is skipped, not leaked into the
-//     first line's content (byte offsets remain true source offsets, so the
-//     first line of a BOM'd file starts at offset 3);
-//   - end of stream is a 0-byte Read(), which works for pipes and virtual
-//     URIs where SeekPosition()/GetFileSize() throw.
-// Memory stays bounded (longest line + one chunk) because consumed bytes are
-// compacted away on refill — except after SlurpAll(), which deliberately
-// buffers the whole stream to resolve from-end references on sources that
-// cannot rewind.
-// =============================================================================
-class BufferedLineReader {
-public:
-	explicit BufferedLineReader(FileHandle &file) : file(file) {
+// Start pipe sources from the file list until max_pipes are running.
+static void LaunchPipes(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data) {
+	while (state.pipes.size() < state.max_pipes) {
+		while (state.pipe_cursor < bind_data.files.size() &&
+		       !IsConcurrentPipe(bind_data, bind_data.files[state.pipe_cursor].path)) {
+			state.pipe_cursor++;
+		}
+		if (state.pipe_cursor >= bind_data.files.size()) {
+			return;
+		}
+		auto &path = bind_data.files[state.pipe_cursor].path;
+		state.launched[state.pipe_cursor++] = true;
+		state.opening_path = path;
+		LaunchedPipe pipe;
+		pipe.path = path;
+		pipe.file_index = state.pipe_cursor - 1;
+		pipe.handle = state.fs->OpenFile(path, FileFlags::FILE_FLAGS_READ);
+		pipe.source = OpenReadAheadSource(*pipe.handle, state.pipe_signal);
+		pipe.abandoned_readers = state.abandoned_readers;
+		state.pipes.push_back(std::move(pipe));
 	}
+}
+
+// Make launched pipe `i` the current source.
+static void TakePipe(ReadTextLinesScanState &state, idx_t i) {
+	auto &pipe = state.pipes[i];
+	state.current_file = std::move(pipe.handle);
+	state.source = std::move(pipe.source);
+	state.current_file_path = std::move(pipe.path);
+	state.opening_path = state.current_file_path;
+	state.writer.file = LineFileMetadata();
+	state.writer.file.index = pipe.file_index;
+	state.reader = make_uniq<BufferedLineReader>(*state.source);
+	state.pipes.erase(state.pipes.begin() + static_cast<int64_t>(i));
+}
 
-	// Extract the next line, including its terminator. Returns false at end of
-	// stream. start_offset is the byte offset of the line's first content byte
-	// in the source.
-	bool NextLine(string &line, int64_t &start_offset) {
-		if (!EnsureLineBuffered()) {
+// Make the first launched pipe with output (or at its end) the current
+// source. With `wait`, blocks until one has; false when none is running.
+static bool TakeReadyPipe(ReadTextLinesScanState &state, bool wait) {
+	while (!state.pipes.empty()) {
+		auto seen = state.pipe_signal->Generation();
+		for (idx_t i = 0; i < state.pipes.size(); i++) {
+			if (state.pipes[i].source->Ready()) {
+				TakePipe(state, i);
+				return true;
+			}
+		}
+		if (!wait) {
 			return false;
 		}
-		start_offset = buffer_base + static_cast<int64_t>(pos);
-		line = ExtractLine(buffer, pos);
-		return true;
+		state.pipe_signal->Wait(seen);
 	}
+	return false;
+}
 
-	// Buffer the whole remaining stream. Needed before CountBufferedLines() on
-	// non-seekable sources, which cannot be rewound after counting.
-	void SlurpAll() {
-		SkipBOM();
-		while (!eof) {
-			Fill();
+// Fill state.writer.file for bind_data.files[index], when its size or
+// modification time is projected: from what the glob already returned
+// (remote file systems list both), else from `handle` or a handle opened
+// for the purpose (archives).
+static void LoadFileMetadata(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data, idx_t index,
+                             FileHandle *handle) {
+	auto &metadata = state.writer.file;
+	metadata = LineFileMetadata();
+	metadata.index = index;
+	if (!state.wants_file_stats) {
+		return;
+	}
+	auto &file_info = bind_data.files[index];
+	if (file_info.extended_info) {
+		auto &options = file_info.extended_info->options;
+		auto size = options.find("file_size");
+		auto mtime = options.find("last_modified");
+		try {
+			if (size != options.end() && !size->second.IsNull()) {
+				metadata.size = size->second.GetValue<int64_t>();
+				metadata.has_size = true;
+			}
+			if (mtime != options.end() && !mtime->second.IsNull()) {
+				metadata.mtime = mtime->second.DefaultCastAs(LogicalType::TIMESTAMP).GetValue<timestamp_t>();
+				metadata.has_mtime = true;
+			}
+		} catch (std::exception &) {
+			metadata = LineFileMetadata();
+			metadata.index = index;
+		}
+		if (metadata.has_size && metadata.has_mtime) {
+			return;
 		}
 	}
-
-	// Lines from the current position to end of stream. Call after SlurpAll()
-	// and before any NextLine().
-	int64_t CountBufferedLines() const {
-		return CountLinesInText(buffer, pos);
+	unique_ptr<FileHandle> own_handle;
+	if (!handle) {
+		own_handle = state.fs->OpenFile(file_info.path, FileFlags::FILE_FLAGS_READ);
+		handle = own_handle.get();
 	}
+	if (!handle->CanSeek()) {
+		return;
+	}
+	try {
+		if (!metadata.has_size) {
+			metadata.size = static_cast<int64_t>(handle->GetFileSize());
+			metadata.has_size = true;
+		}
+		if (!metadata.has_mtime) {
+			metadata.mtime = compat::LastModifiedTimestamp(state.fs->GetLastModifiedTime(*handle));
+			metadata.has_mtime = true;
+		}
+	} catch (std::exception &) {
+		// Left NULL where the file system cannot say
+	}
+}
 
-private:
-	static constexpr idx_t FILL_CHUNK_SIZE = 65536;
-
-	// Ensure the buffer holds a complete line starting at pos (or the final
-	// unterminated line once eof is reached). Returns false at end of stream.
-	bool EnsureLineBuffered() {
-		SkipBOM();
-		while (true) {
-			auto term = buffer.find_first_of("\r\n", pos);
-			if (term != string::npos) {
-				// A '\r' as the last buffered byte may be the first half of a
-				// '\r\n' spanning a read boundary; decide after the next fill.
-				if (buffer[term] == '\r' && term + 1 == buffer.size() && !eof) {
-					Fill();
-					continue;
-				}
-				return true;
+// Open the next file, or member of the current archive, as state.reader.
+// Returns false when there are none left.
+static bool OpenNextSource(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data) {
+	while (true) {
+		if (state.archive) {
+			string member;
+			state.opening_path = state.archive_path;
+			try {
+				state.source = state.archive->NextMember(member);
+			} catch (std::exception &) {
+				// The archive itself is unreadable from here on
+				state.archive.reset();
+				throw;
 			}
-			if (eof) {
-				return pos < buffer.size();
+			if (state.source) {
+				state.reader = make_uniq<BufferedLineReader>(*state.source);
+				state.current_file_path = state.archive_path + "/" + member;
+				state.opening_path = state.current_file_path;
+				return true;
 			}
-			Fill();
+			state.archive.reset();
 		}
-	}
-
-	// Skip a UTF-8 byte-order mark at the very start of the stream. Runs
-	// before the first line is parsed and never again.
-	void SkipBOM() {
-		while (!bom_checked) {
-			if (buffer.size() >= 3) {
-				if (buffer.compare(0, 3, "\xEF\xBB\xBF") == 0) {
-					pos = 3;
+		idx_t file_position;
+		if (state.work) {
+			// Parallel scans have no pipes: files come from the shared queue
+			if (!state.work->Claim(*state.fs, state.item)) {
+				return false;
+			}
+			file_position = state.item.file;
+		} else {
+			LaunchPipes(state, bind_data);
+			if (bind_data.global_line_number) {
+				// In list order: pipes launch in that order too, so the next
+				// launched file is the oldest running pipe
+				if (state.file_index < bind_data.files.size() && state.launched[state.file_index]) {
+					state.file_index++;
+					TakePipe(state, 0);
+					return true;
 				}
-				bom_checked = true;
-			} else if (eof) {
-				bom_checked = true;
 			} else {
-				Fill();
+				// A pipe with output is taken first; otherwise regular files are
+				// read while the pipes run, and the scan only waits on pipes at the end
+				if (TakeReadyPipe(state, false)) {
+					return true;
+				}
+				while (state.file_index < bind_data.files.size() && state.launched[state.file_index]) {
+					state.file_index++;
+				}
 			}
+			if (state.file_index >= bind_data.files.size()) {
+				return TakeReadyPipe(state, true);
+			}
+			file_position = state.file_index++;
 		}
-	}
-
-	void Fill() {
-		if (eof) {
-			return;
+		auto &file_info = bind_data.files[file_position];
+		state.opening_path = file_info.path;
+
+		auto compression = ResolveLineCompression(bind_data.compression, file_info.path);
+		if (!bind_data.archive_members.empty()) {
+			state.archive = LineArchive::Open(*state.fs, file_info.path, bind_data.archive_members, compression,
+			                                  state.decompress_threads);
+			state.archive_path = file_info.path;
+			// Members report the archive's index, size and time
+			LoadFileMetadata(state, bind_data, file_position, nullptr);
+			continue;
 		}
-		// Compact consumed bytes so streaming reads don't accumulate the whole
-		// source. pos stays 0-based within the buffer; buffer_base keeps
-		// start offsets equal to true source offsets.
-		if (pos > 0) {
-			buffer.erase(0, pos);
-			buffer_base += static_cast<int64_t>(pos);
-			pos = 0;
-		}
-		char chunk[FILL_CHUNK_SIZE];
-		int64_t bytes_read = file.Read(chunk, FILL_CHUNK_SIZE);
-		if (bytes_read <= 0) {
-			eof = true;
-			return;
+		state.source = OpenDecompressingSource(*state.fs, file_info.path, compression, state.decompress_threads,
+		                                       state.current_file);
+		if (state.source) {
+			state.reader = make_uniq<BufferedLineReader>(*state.source);
+		} else {
+			if (state.prefetched_file) {
+				state.current_file = std::move(state.prefetched_file);
+			} else {
+				state.current_file = state.fs->OpenFile(file_info.path, FileFlags::FILE_FLAGS_READ);
+			}
+			if (bind_data.flush_interval_us >= 0 && !state.current_file->CanSeek()) {
+				// A stream is read on a read-ahead thread, so the scan can
+				// stop waiting on it at the flush deadline
+				state.source = OpenReadAheadSource(*state.current_file, nullptr);
+				state.reader = make_uniq<BufferedLineReader>(*state.source);
+			} else {
+				state.reader = make_uniq<BufferedLineReader>(*state.current_file);
+			}
 		}
-		buffer.append(chunk, static_cast<size_t>(bytes_read));
+		LoadFileMetadata(state, bind_data, file_position, state.current_file.get());
+		state.current_file_path = file_info.path;
+		return true;
 	}
+}
 
-	FileHandle &file;
-	string buffer;
-	idx_t pos = 0;
-	int64_t buffer_base = 0;
-	bool eof = false;
-	bool bom_checked = false;
-};
-
-// Count total lines by scanning the stream through a reader (for resolving
-// from-end references on seekable sources; the caller rewinds afterwards).
-static int64_t CountLinesInStream(BufferedLineReader &reader) {
-	string line;
-	int64_t offset;
-	int64_t count = 0;
-	while (reader.NextLine(line, offset)) {
-		count++;
+// global_line_number: the number of lines in the file being closed. A scan
+// that stopped early takes it from the file's index or from-end count, or
+// else counts the rest of the file.
+static int64_t FinishedFileLines(ReadTextLinesScanState &state) {
+	if (state.file_at_eof || !state.reader) {
+		return state.current_line_number;
+	}
+	if (state.file_total_lines >= 0) {
+		return state.file_total_lines;
+	}
+	if (state.line_index) {
+		return state.line_index->total_lines;
+	}
+	try {
+		return state.current_line_number + CountLinesInStream(*state.reader);
+	} catch (std::exception &) {
+		// A read error ends the file where it stopped (ignore_errors)
+		return state.current_line_number;
 	}
-	return count;
 }
 
-static bool OpenNextFile(ReadTextLinesGlobalState &state, const ReadTextLinesBindData &bind_data) {
-	while (state.file_index < bind_data.files.size()) {
-		auto &file_info = bind_data.files[state.file_index];
-		state.file_index++;
+// The current file's selection, with from-end references resolved against
+// `total_lines` when it is known (>= 0)
+static void ResolveFileSelection(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                                 int64_t total_lines) {
+	if (state.specs.empty()) {
+		state.resolved_selection = bind_data.line_selection;
+		if (total_lines >= 0) {
+			state.resolved_selection.ResolveFromEnd(total_lines);
+		}
+		return;
+	}
+	vector<LineSelection> selections;
+	for (auto &spec : state.specs) {
+		if (total_lines >= 0) {
+			spec.selection.ResolveFromEnd(total_lines);
+		}
+		selections.push_back(spec.selection);
+	}
+	state.resolved_selection = LineSelection::Union(selections);
+}
 
+static bool OpenNextFile(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data) {
+	if (state.counting_lines) {
+		state.writer.line_base += FinishedFileLines(state);
+		state.counting_lines = false;
+	}
+	while (true) {
 		try {
-			state.current_file = state.fs->OpenFile(file_info.path, FileFlags::FILE_FLAGS_READ);
-			state.current_file_path = file_info.path;
+			// The reader and source may still be reading the previous file
+			state.reader.reset();
+			state.source.reset();
+			if (!OpenNextSource(state, bind_data)) {
+				return false;
+			}
+			// Pin what this scan sees of the file, so that counting and
+			// emitting passes agree however much a writer appends meanwhile:
+			// its size at bind, or now if it was not pinned then
+			state.snapshot_end = -1;
+			if (bind_data.snapshot && !state.source && state.current_file->CanSeek()) {
+				state.snapshot_end = static_cast<int64_t>(state.current_file->GetFileSize());
+				auto file_position = state.writer.file.index;
+				if (file_position < bind_data.snapshot_sizes.size() && bind_data.snapshot_sizes[file_position] >= 0) {
+					state.snapshot_end = MinValue(state.snapshot_end, bind_data.snapshot_sizes[file_position]);
+				}
+				state.writer.file.has_size = true;
+				state.writer.file.size = state.snapshot_end;
+			}
+			if (state.item.byte_end >= 0) {
+				// A range of the file: its reader stops where the next begins
+				state.snapshot_end = state.snapshot_end >= 0 ? MinValue(state.snapshot_end, state.item.byte_end)
+				                                             : state.item.byte_end;
+			}
+			if (bind_data.snapshot || bind_data.complete_lines || state.snapshot_end >= 0) {
+				state.reader->SetSnapshot(state.snapshot_end, bind_data.complete_lines);
+			}
 			state.current_line_number = 0;
 			state.file_finished = false;
-			state.reader = make_uniq<BufferedLineReader>(*state.current_file);
+			state.counting_lines = bind_data.global_line_number;
+			state.file_at_eof = false;
+			state.file_total_lines = -1;
+			state.line_index.reset();
+			state.next_block = 0;
+			state.skip_by_trigrams = false;
+			state.skip_by_time = false;
+			state.ring_size = 0;
+			state.after_remaining = 0;
+
+			// An index of this file version (cached, from a sidecar, or
+			// extended from one of an earlier version of an appended file)
+			// lets the scan skip blocks, or the whole file, that cannot match.
+			// A range keeps the index it was cut from, whose blocks it spans.
+			FileIdentity identity;
+			bool want_trigrams = !bind_data.required_substrings.empty();
+			bool want_time = bind_data.has_time_filter;
+			if ((want_trigrams || want_time) && !state.source && GetFileIdentity(*state.current_file, identity)) {
+				auto index = state.item.index;
+				if (!index) {
+					index = LineIndex::Find(*state.fs, state.current_file_path, *state.current_file, identity);
+				}
+				if (index) {
+					state.skip_by_trigrams = want_trigrams && index->HasTrigrams();
+					state.skip_by_time =
+					    want_time && index->HasTimestamps(bind_data.timestamp_parser->Format());
+					if (state.skip_by_trigrams || state.skip_by_time) {
+						state.line_index = std::move(index);
+					}
+				}
+			}
 
-			if (bind_data.line_selection.HasFromEndReferences()) {
+			// In spec mode the file's selection is the union of those of the
+			// list entries naming it; each line is then emitted per entry
+			state.specs.clear();
+			if (!bind_data.file_specs.empty()) {
+				state.specs = bind_data.file_specs[state.writer.file.index];
+			}
+			bool from_end = state.specs.empty() && bind_data.line_selection.HasFromEndReferences();
+			for (auto &spec : state.specs) {
+				from_end = from_end || spec.selection.HasFromEndReferences();
+			}
+			int64_t total_lines = -1;
+			shared_ptr<LineIndex> count_index;
+			if (from_end) {
 				// From-end references (e.g. '+2' = 2nd line from the end) need
 				// the total line count before any line can be emitted.
-				int64_t total_lines;
-				if (state.current_file->CanSeek()) {
+				if (!state.source && state.current_file->CanSeek()) {
+					count_index = FromEndIndex(state, bind_data);
+				}
+				if (count_index) {
+					total_lines = count_index->total_lines;
+				} else if (!state.source && state.current_file->CanSeek()) {
 					total_lines = CountLinesInStream(*state.reader);
 					state.current_file->Seek(0);
-					state.reader = make_uniq<BufferedLineReader>(*state.current_file);
+					ResetFileReader(state, bind_data, 0);
 				} else {
-					// Pipes and streams cannot rewind after counting: buffer
-					// the whole stream and serve lines from the buffer.
+					// Pipes, streams and decompressed data cannot rewind
+					// after counting: buffer the whole stream and serve lines
+					// from the buffer.
 					state.reader->SlurpAll();
 					total_lines = state.reader->CountBufferedLines();
 				}
-				state.resolved_selection = bind_data.line_selection;
-				state.resolved_selection.ResolveFromEnd(total_lines);
-			} else {
-				state.resolved_selection = bind_data.line_selection;
+				state.file_total_lines = total_lines;
+			}
+			ResolveFileSelection(state, bind_data, total_lines);
+			if (count_index) {
+				SeekToIndexedLine(state, bind_data, *count_index, state.resolved_selection.MinLine());
+			}
+			if (state.item.byte_end >= 0) {
+				// Ranges are only cut where the index knows the line number
+				state.current_file->Seek(static_cast<idx_t>(state.item.byte_start));
+				ResetFileReader(state, bind_data, state.item.byte_start);
+				state.current_line_number = state.item.first_line - 1;
+				if (state.line_index) {
+					// Its range's own index: first_block is one of its blocks
+					state.next_block = state.item.first_block;
+				}
 			}
 
+			if (state.line_index && !SeekToCandidateBlock(state, bind_data, state.next_block)) {
+				// Nothing in the file can match (count_only still reports it)
+				state.file_finished = true;
+			}
 			return true;
 		} catch (std::exception &e) {
 			if (!bind_data.ignore_errors) {
 				throw;
 			}
+			if (bind_data.rejects) {
+				state.file_rejects.emplace_back(state.opening_path, ErrorData(e).RawMessage());
+			}
+			// A file, or archive member, that failed partway through setup
+			// counts as empty; the archive's other members are still read
+			// (an archive that cannot be walked was dropped where it failed)
+			state.counting_lines = false;
+			state.reader.reset();
+			state.source.reset();
+			continue;
+		}
+	}
+}
+
+// Route a line through `match` / `match_any`: returns true when it is output,
+// either as a match (with line.match_id set) or as after-context. A match
+// first queues the held before-context lines (oldest first) in state.pending;
+// a line that is neither is remembered in the ring as potential
+// before-context.
+static bool TakeMatchContext(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                             LineRow &line) {
+	auto ring_capacity = static_cast<idx_t>(bind_data.match_before);
+	bool matched = bind_data.matcher->Match(line.data, line.size, line.match_id);
+	if (bind_data.invert) {
+		// The selected lines are the ones no pattern matched
+		matched = !matched;
+		line.match_id = DConstants::INVALID_INDEX;
+	}
+	if (matched) {
+		for (idx_t i = 0; i < state.ring_size; i++) {
+			auto slot = (state.ring_next + ring_capacity - state.ring_size + i) % ring_capacity;
+			state.pending.push_back(std::move(state.before_ring[slot]));
+		}
+		state.ring_size = 0;
+		state.after_remaining = bind_data.match_after;
+		return true;
+	}
+	if (state.after_remaining > 0) {
+		state.after_remaining--;
+		return true;
+	}
+	if (ring_capacity > 0) {
+		if (state.before_ring.size() < ring_capacity) {
+			// Still filling: slots are in order and ring_next is the end
+			state.before_ring.emplace_back();
+		}
+		state.before_ring[state.ring_next].Assign(line);
+		state.ring_next = (state.ring_next + 1) % ring_capacity;
+		state.ring_size = MinValue<idx_t>(state.ring_size + 1, ring_capacity);
+	}
+	return false;
+}
+
+// Advance to the next line of the current file that the line selection
+// includes, seeking past index blocks that cannot match. Returns false, with
+// file_finished set, once the file has no more such lines; or, without it,
+// when flush_interval is armed and the source stayed quiet until the deadline.
+static bool NextSelectedLine(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                             LineRow &line) {
+	while (!state.file_finished) {
+		bool have_line;
+		try {
+			// With a flush deadline, wait for the source only until then: bytes
+			// that arrive meanwhile are buffered, and a partial line is not
+			// waited on to its end
+			while (state.flush_armed && state.source && !state.reader->HasBufferedLine()) {
+				if (!state.source->WaitReady(state.flush_deadline)) {
+					return false;
+				}
+				state.reader->FillReady();
+			}
+			have_line = state.reader->NextLine(line.data, line.size, line.byte_offset);
+		} catch (std::exception &e) {
+			// A genuine mid-read I/O error (EOF is a 0-byte read, not an
+			// exception). Skip the rest of the file only if asked to.
+			if (!bind_data.ignore_errors) {
+				throw;
+			}
+			// The file ends where the read stopped
+			state.file_at_eof = true;
+			if (bind_data.rejects) {
+				// Reported as a row for the file
+				state.read_error = ErrorData(e).RawMessage();
+				state.file_finished = true;
+				line.line_number = -1;
+				line.byte_offset = -1;
+				line.data = nullptr;
+				line.size = 0;
+				line.match_id = DConstants::INVALID_INDEX;
+				line.reject_reason = state.read_error.c_str();
+				return true;
+			}
+			have_line = false;
+		}
+		if (!have_line) {
+			state.file_finished = true;
+			state.file_at_eof = true;
+			break;
+		}
+		if (state.line_index && !EnterIndexedBlock(state, bind_data, line.byte_offset)) {
+			continue;
+		}
+
+		state.current_line_number++;
+
+		if (!state.resolved_selection.ShouldIncludeLine(state.current_line_number)) {
+			if (state.resolved_selection.PastAllRanges(state.current_line_number)) {
+				state.file_finished = true;
+				break;
+			}
 			continue;
 		}
+		line.line_number = state.current_line_number;
+		line.match_id = DConstants::INVALID_INDEX;
+		line.reject_reason = nullptr;
+		return true;
 	}
 	return false;
 }
 
+// count_only: one row per file with the number of selected lines that match
+// (or, with invert, do not match). Lines are matched in the reader buffer and
+// never become strings.
+static void CountMatchingLines(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                               DataChunk &output) {
+	idx_t output_row = 0;
+	while (output_row < STANDARD_VECTOR_SIZE && OpenNextFile(state, bind_data)) {
+		int64_t count = 0;
+		LineRow line;
+		while (NextSelectedLine(state, bind_data, line)) {
+			if (!bind_data.matcher || bind_data.matcher->Matches(line.data, line.size) != bind_data.invert) {
+				count++;
+			}
+		}
+		for (idx_t col = 0; col < state.projected.size(); col++) {
+			auto &vec = output.data[col];
+			if (state.projected[col] == ReadLinesColumn::FILE_PATH) {
+				FlatVector::GetData<string_t>(vec)[output_row] = StringVector::AddString(vec, state.current_file_path);
+			} else if (state.projected[col] == ReadLinesColumn::MATCH_COUNT) {
+				FlatVector::GetData<int64_t>(vec)[output_row] = count;
+			}
+		}
+		output_row++;
+	}
+	CompatSetOutputCardinality(output, output_row);
+}
+
+// flush_interval: the chunk's first row starts the clock, and once it holds
+// min_batch rows the scan stops waiting on quiet sources at the deadline.
+static void NoteRowWritten(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                           idx_t output_row) {
+	if (bind_data.flush_interval_us < 0) {
+		return;
+	}
+	if (output_row == 1) {
+		state.chunk_started = std::chrono::steady_clock::now();
+	}
+	if (output_row == bind_data.min_batch) {
+		state.flush_armed = true;
+		state.flush_deadline = state.chunk_started + std::chrono::microseconds(bind_data.flush_interval_us);
+	}
+}
+
+// Whether opening the next source would wait on pipes with no output yet.
+static bool NextSourceWouldWait(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data) {
+	if (state.archive) {
+		return false;
+	}
+	auto next = state.file_index;
+	while (next < bind_data.files.size() && state.launched[next]) {
+		next++;
+	}
+	if (next < bind_data.files.size() && !IsConcurrentPipe(bind_data, bind_data.files[next].path)) {
+		return false;
+	}
+	for (auto &pipe : state.pipes) {
+		if (pipe.source->Ready()) {
+			return false;
+		}
+	}
+	return !state.pipes.empty() || next < bind_data.files.size();
+}
+
+// The small-window fast path: one positional read of the file's first
+// SMALL_WINDOW_BYTES (all of a smaller file) and rows cut straight from it,
+// without a line reader. Returns false, having written nothing, when the
+// window does not end inside that read; the general path then takes over,
+// reusing the open handle.
+static constexpr idx_t SMALL_WINDOW_BYTES = 64 << 10;
+
+static bool ReadSmallWindow(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data,
+                            DataChunk &output, idx_t &output_row) {
+	state.small_window = false;
+	auto &file_info = bind_data.files[0];
+	unique_ptr<FileHandle> handle;
+	idx_t file_size;
+	idx_t read_size;
+	string buffer;
+	try {
+		handle = state.fs->OpenFile(file_info.path, FileFlags::FILE_FLAGS_READ);
+		if (!handle->CanSeek()) {
+			state.prefetched_file = std::move(handle);
+			return false;
+		}
+		file_size = handle->GetFileSize();
+		read_size = MinValue<idx_t>(file_size, SMALL_WINDOW_BYTES);
+		buffer.resize(read_size);
+		handle->Read(&buffer[0], read_size, 0);
+	} catch (std::exception &) {
+		return false; // Reported (or ignored) by the general path
+	}
+
+	// Lines are split as BufferedLineReader splits them: a leading BOM is
+	// skipped, and a line is only complete once its terminator was read
+	// (or the file ends)
+	struct WindowLine {
+		int64_t line_number;
+		idx_t start;
+		idx_t end;
+	};
+	vector<WindowLine> lines;
+	auto &selection = bind_data.line_selection;
+	auto max_line = selection.MaxLine();
+	idx_t pos = read_size >= 3 && buffer.compare(0, 3, "\xEF\xBB\xBF") == 0 ? 3 : 0;
+	int64_t line_number = 0;
+	bool complete = read_size == file_size;
+	while (pos < read_size && line_number < max_line) {
+		auto end = FindLineEnd(buffer.data(), read_size, pos);
+		if (end == read_size && read_size < file_size) {
+			break;
+		}
+		line_number++;
+		if (selection.ShouldIncludeLine(line_number)) {
+			lines.push_back(WindowLine {line_number, pos, end});
+		}
+		pos = end;
+	}
+	complete = complete || line_number >= max_line;
+	if (!complete) {
+		handle->Seek(0);
+		state.prefetched_file = std::move(handle);
+		return false;
+	}
+
+	state.file_index = 1;
+	state.current_file_path = file_info.path;
+	LoadFileMetadata(state, bind_data, 0, handle.get());
+	for (auto &window_line : lines) {
+		LineRow line {window_line.line_number, buffer.data() + window_line.start, window_line.end - window_line.start,
+		              static_cast<int64_t>(window_line.start), DConstants::INVALID_INDEX, nullptr};
+		if (Utf8Proc::Analyze(line.data, line.size) == UnicodeType::INVALID) {
+			if (bind_data.ignore_errors) {
+				continue;
+			}
+			throw InvalidInputException(
+			    "read_lines: line %lld of \"%s\" is not valid UTF-8; set ignore_errors=true to skip such lines",
+			    line.line_number, state.current_file_path);
+		}
+		state.writer.Write(output, output_row++, state.projected, line, state.current_file_path);
+	}
+	return true;
+}
+
+// Write `line` as the next output row. In spec mode it is written once per
+// list entry whose selection includes it, labelled with the entry's
+// spec_index; rows past the first wait in pending. Rejects without a line
+// number belong to no entry.
+static void EmitLine(ReadTextLinesScanState &state, const ReadTextLinesBindData &bind_data, DataChunk &output,
+                     idx_t &output_row, const LineRow &line) {
+	if (state.specs.empty() || line.line_number < 0) {
+		state.writer.spec_index = DConstants::INVALID_INDEX;
+		state.writer.Write(output, output_row, state.projected, line, state.current_file_path);
+		NoteRowWritten(state, bind_data, ++output_row);
+		return;
+	}
+	bool written = false;
+	for (auto &spec : state.specs) {
+		if (!spec.selection.ShouldIncludeLine(line.line_number)) {
+			continue;
+		}
+		if (written) {
+			state.pending.emplace_back();
+			state.pending.back().Assign(line);
+			state.pending.back().spec_index = spec.spec_index;
+			continue;
+		}
+		state.writer.spec_index = spec.spec_index;
+		state.writer.Write(output, output_row, state.projected, line, state.current_file_path);
+		NoteRowWritten(state, bind_data, ++output_row);
+		written = true;
+	}
+}
+
 static void ReadTextLinesFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
 	auto &bind_data = data_p.bind_data->Cast<ReadTextLinesBindData>();
-	auto &state = data_p.global_state->Cast<ReadTextLinesGlobalState>();
+	auto &global_state = data_p.global_state->Cast<ReadTextLinesGlobalState>();
+	auto &state =
+	    global_state.work ? *data_p.local_state->Cast<ReadTextLinesLocalState>().scan : global_state.scan;
+
+	if (bind_data.count_only) {
+		CountMatchingLines(state, bind_data, output);
+		return;
+	}
 
 	idx_t output_row = 0;
+	if (state.small_window && ReadSmallWindow(state, bind_data, output, output_row)) {
+		CompatSetOutputCardinality(output, output_row);
+		return;
+	}
+	state.flush_armed = false;
 
 	while (output_row < STANDARD_VECTOR_SIZE) {
+		if (!state.file_rejects.empty()) {
+			auto &reject = state.file_rejects.front();
+			state.writer.WriteReject(output, output_row, state.projected, reject.first, -1, -1,
+			                         reject.second.c_str());
+			state.file_rejects.pop_front();
+			NoteRowWritten(state, bind_data, ++output_row);
+			continue;
+		}
+		// Rows held over from the previous line or chunk (they belong to the
+		// current file, so they go out before the next file is opened)
+		if (!state.pending.empty()) {
+			state.writer.spec_index = state.pending.front().spec_index;
+			state.writer.Write(output, output_row, state.projected, state.pending.front().View(),
+			                   state.current_file_path);
+			state.pending.pop_front();
+			NoteRowWritten(state, bind_data, ++output_row);
+			continue;
+		}
 		if (state.file_finished) {
-			if (!OpenNextFile(state, bind_data)) {
+			if (state.flush_armed && NextSourceWouldWait(state, bind_data)) {
 				break;
 			}
-		}
-
-		while (output_row < STANDARD_VECTOR_SIZE && !state.file_finished) {
-			string line;
-			int64_t line_start_offset;
-			bool have_line;
-			try {
-				have_line = state.reader->NextLine(line, line_start_offset);
-			} catch (std::exception &) {
-				// A genuine mid-read I/O error (EOF is a 0-byte read, not an
-				// exception). Skip the rest of the file only if asked to.
-				if (!bind_data.ignore_errors) {
-					throw;
-				}
-				have_line = false;
+			bool opened = OpenNextFile(state, bind_data);
+			if (!state.file_rejects.empty()) {
+				continue; // Report the files that failed first
 			}
-			if (!have_line) {
-				state.file_finished = true;
+			if (!opened) {
 				break;
 			}
+		}
 
-			state.current_line_number++;
-
-			if (!state.resolved_selection.ShouldIncludeLine(state.current_line_number)) {
-				if (state.resolved_selection.PastAllRanges(state.current_line_number)) {
-					state.file_finished = true;
-					break;
-				}
+		LineRow line;
+		while (output_row < STANDARD_VECTOR_SIZE && state.pending.empty() &&
+		       NextSelectedLine(state, bind_data, line)) {
+			if (line.reject_reason) {
+				EmitLine(state, bind_data, output, output_row, line);
 				continue;
 			}
-
 			// VARCHAR requires valid UTF-8; a bad byte must not abort the whole
 			// scan when the user opted into ignore_errors (the line keeps its
 			// number so subsequent line numbers stay true to the file).
-			if (Utf8Proc::Analyze(line.c_str(), line.size()) == UnicodeType::INVALID) {
+			if (Utf8Proc::Analyze(line.data, line.size) == UnicodeType::INVALID) {
+				if (bind_data.rejects) {
+					line.reject_reason = "invalid UTF-8";
+					EmitLine(state, bind_data, output, output_row, line);
+					continue;
+				}
 				if (bind_data.ignore_errors) {
 					continue;
 				}
 				throw InvalidInputException(
 				    "read_lines: line %lld of \"%s\" is not valid UTF-8; set ignore_errors=true to skip such lines",
-				    state.current_line_number, state.current_file_path);
+				    line.line_number, state.current_file_path);
 			}
 
-			output.data[0].SetValue(output_row, Value::BIGINT(state.current_line_number));
-			output.data[1].SetValue(output_row, Value(ApplyLineTrim(line, bind_data.trim_mode)));
-			output.data[2].SetValue(output_row, Value::BIGINT(line_start_offset));
-			output.data[3].SetValue(output_row, Value(state.current_file_path));
-
-			output_row++;
+			if (bind_data.matcher && !TakeMatchContext(state, bind_data, line)) {
+				continue;
+			}
+			if (!state.pending.empty()) {
+				// Queued before-context goes first
+				state.pending.emplace_back();
+				state.pending.back().Assign(line);
+				continue;
+			}
+			EmitLine(state, bind_data, output, output_row, line);
+		}
+		if (!state.file_finished && state.pending.empty() && output_row < STANDARD_VECTOR_SIZE) {
+			// The source went quiet past the flush deadline
+			break;
 		}
 	}
 
@@ -394,34 +2422,91 @@ static void ReadTextLinesFunction(ClientContext &context, TableFunctionInput &da
 TableFunctionSet ReadLinesFunction() {
 	TableFunctionSet set("read_lines");
 
-	// Single argument: read_lines(path)
-	TableFunction func1("read_lines", {LogicalType::VARCHAR}, ReadTextLinesFunction, ReadTextLinesBind,
-	                    ReadTextLinesInit);
+	// Single argument: read_lines(path), where path may be a list of paths
+	TableFunction func1("read_lines", {LogicalType::ANY}, ReadTextLinesFunction, ReadTextLinesBind,
+	                    ReadTextLinesInit, ReadTextLinesLocalInit);
 	func1.named_parameters["lines"] = LogicalType::ANY;
 	func1.named_parameters["trim"] = LogicalType::ANY;
+	func1.named_parameters["split"] = LogicalType::VARCHAR;
+	func1.named_parameters["content_hash"] = LogicalType::BOOLEAN;
+	func1.named_parameters["global_line_number"] = LogicalType::BOOLEAN;
+	func1.named_parameters["snapshot"] = LogicalType::BOOLEAN;
+	func1.named_parameters["complete_lines"] = LogicalType::BOOLEAN;
+	func1.named_parameters["parallel"] = LogicalType::BOOLEAN;
+	func1.named_parameters["template"] = LogicalType::BOOLEAN;
+	func1.named_parameters["timestamp_format"] = LogicalType::VARCHAR;
+	func1.named_parameters["match"] = LogicalType::VARCHAR;
+	func1.named_parameters["match_any"] = LogicalType::LIST(LogicalType::VARCHAR);
+	func1.named_parameters["invert"] = LogicalType::BOOLEAN;
+	func1.named_parameters["count_only"] = LogicalType::BOOLEAN;
+	func1.named_parameters["compression"] = LogicalType::VARCHAR;
+	func1.named_parameters["flush_interval"] = LogicalType::INTERVAL;
+	func1.named_parameters["min_batch"] = LogicalType::BIGINT;
 	func1.named_parameters["before"] = LogicalType::BIGINT;
 	func1.named_parameters["after"] = LogicalType::BIGINT;
 	func1.named_parameters["context"] = LogicalType::BIGINT;
 	func1.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+	func1.named_parameters["rejects"] = LogicalType::BOOLEAN;
+	func1.projection_pushdown = true;
+	func1.pushdown_complex_filter = ReadTextLinesPushdownComplexFilter;
+	func1.get_virtual_columns = ReadTextLinesGetVirtualColumns;
 	set.AddFunction(func1);
 
 	// Two arguments: read_lines(path, lines)
-	TableFunction func2("read_lines", {LogicalType::VARCHAR, LogicalType::ANY}, ReadTextLinesFunction,
-	                    ReadTextLinesBind, ReadTextLinesInit);
+	TableFunction func2("read_lines", {LogicalType::ANY, LogicalType::ANY}, ReadTextLinesFunction,
+	                    ReadTextLinesBind, ReadTextLinesInit, ReadTextLinesLocalInit);
 	func2.named_parameters["trim"] = LogicalType::ANY;
+	func2.named_parameters["split"] = LogicalType::VARCHAR;
+	func2.named_parameters["content_hash"] = LogicalType::BOOLEAN;
+	func2.named_parameters["global_line_number"] = LogicalType::BOOLEAN;
+	func2.named_parameters["snapshot"] = LogicalType::BOOLEAN;
+	func2.named_parameters["complete_lines"] = LogicalType::BOOLEAN;
+	func2.named_parameters["parallel"] = LogicalType::BOOLEAN;
+	func2.named_parameters["template"] = LogicalType::BOOLEAN;
+	func2.named_parameters["timestamp_format"] = LogicalType::VARCHAR;
+	func2.named_parameters["match"] = LogicalType::VARCHAR;
+	func2.named_parameters["match_any"] = LogicalType::LIST(LogicalType::VARCHAR);
+	func2.named_parameters["invert"] = LogicalType::BOOLEAN;
+	func2.named_parameters["count_only"] = LogicalType::BOOLEAN;
+	func2.named_parameters["compression"] = LogicalType::VARCHAR;
+	func2.named_parameters["flush_interval"] = LogicalType::INTERVAL;
+	func2.named_parameters["min_batch"] = LogicalType::BIGINT;
 	func2.named_parameters["before"] = LogicalType::BIGINT;
 	func2.named_parameters["after"] = LogicalType::BIGINT;
 	func2.named_parameters["context"] = LogicalType::BIGINT;
 	func2.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+	func2.named_parameters["rejects"] = LogicalType::BOOLEAN;
+	func2.projection_pushdown = true;
+	func2.pushdown_complex_filter = ReadTextLinesPushdownComplexFilter;
+	func2.get_virtual_columns = ReadTextLinesGetVirtualColumns;
 	set.AddFunction(func2);
 
 	// Three arguments: read_lines(path, lines, trim)
-	TableFunction func3("read_lines", {LogicalType::VARCHAR, LogicalType::ANY, LogicalType::ANY}, ReadTextLinesFunction,
-	                    ReadTextLinesBind, ReadTextLinesInit);
+	TableFunction func3("read_lines", {LogicalType::ANY, LogicalType::ANY, LogicalType::ANY}, ReadTextLinesFunction,
+	                    ReadTextLinesBind, ReadTextLinesInit, ReadTextLinesLocalInit);
+	func3.named_parameters["split"] = LogicalType::VARCHAR;
+	func3.named_parameters["content_hash"] = LogicalType::BOOLEAN;
+	func3.named_parameters["global_line_number"] = LogicalType::BOOLEAN;
+	func3.named_parameters["snapshot"] = LogicalType::BOOLEAN;
+	func3.named_parameters["complete_lines"] = LogicalType::BOOLEAN;
+	func3.named_parameters["parallel"] = LogicalType::BOOLEAN;
+	func3.named_parameters["template"] = LogicalType::BOOLEAN;
+	func3.named_parameters["timestamp_format"] = LogicalType::VARCHAR;
+	func3.named_parameters["match"] = LogicalType::VARCHAR;
+	func3.named_parameters["match_any"] = LogicalType::LIST(LogicalType::VARCHAR);
+	func3.named_parameters["invert"] = LogicalType::BOOLEAN;
+	func3.named_parameters["count_only"] = LogicalType::BOOLEAN;
+	func3.named_parameters["compression"] = LogicalType::VARCHAR;
+	func3.named_parameters["flush_interval"] = LogicalType::INTERVAL;
+	func3.named_parameters["min_batch"] = LogicalType::BIGINT;
 	func3.named_parameters["before"] = LogicalType::BIGINT;
 	func3.named_parameters["after"] = LogicalType::BIGINT;
 	func3.named_parameters["context"] = LogicalType::BIGINT;
 	func3.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+	func3.named_parameters["rejects"] = LogicalType::BOOLEAN;
+	func3.projection_pushdown = true;
+	func3.pushdown_complex_filter = ReadTextLinesPushdownComplexFilter;
+	func3.get_virtual_columns = ReadTextLinesGetVirtualColumns;
 	set.AddFunction(func3);
 
 	return set;
@@ -431,6 +2516,10 @@ TableFunctionSet ReadLinesFunction() {
 // Lateral join version: read_lines_lateral
 // =============================================================================
 
+// In-out functions get no projection pushdown: always the four base columns.
+static const vector<ReadLinesColumn> LATERAL_COLUMNS = {ReadLinesColumn::LINE_NUMBER, ReadLinesColumn::CONTENT,
+                                                        ReadLinesColumn::BYTE_OFFSET, ReadLinesColumn::FILE_PATH};
+
 struct ReadTextLinesLateralBindData : public TableFunctionData {
 	LineSelection line_selection;
 	LineTrimMode trim_mode;
@@ -455,6 +2544,7 @@ struct ReadTextLinesLateralState : public LocalTableFunctionState {
 	bool file_open;
 	idx_t current_row;
 	LineSelection resolved_selection; // Per-file resolved selection
+	LineRowWriter writer;
 
 	ReadTextLinesLateralState()
 	    : fs(nullptr), current_line_number(0), file_open(false), current_row(0),
@@ -516,17 +2606,7 @@ static unique_ptr<FunctionData> ReadTextLinesLateralBind(ClientContext &context,
 		trim_mode = ParseLineTrimMode(input.inputs[2]);
 	}
 
-	return_types.push_back(LogicalType::BIGINT);
-	names.push_back("line_number");
-
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("content");
-
-	return_types.push_back(LogicalType::BIGINT);
-	names.push_back("byte_offset");
-
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("file_path");
+	AddReadLinesColumns(LATERAL_COLUMNS, return_types, names);
 
 	return make_uniq<ReadTextLinesLateralBindData>(std::move(line_selection), trim_mode, ignore_errors);
 }
@@ -534,8 +2614,10 @@ static unique_ptr<FunctionData> ReadTextLinesLateralBind(ClientContext &context,
 static unique_ptr<LocalTableFunctionState> ReadTextLinesLateralLocalInit(ExecutionContext &context,
                                                                          TableFunctionInitInput &input,
                                                                          GlobalTableFunctionState *global_state) {
+	auto &bind_data = input.bind_data->Cast<ReadTextLinesLateralBindData>();
 	auto result = make_uniq<ReadTextLinesLateralState>();
 	result->fs = &FileSystem::GetFileSystem(context.client);
+	result->writer.trim_mode = bind_data.trim_mode;
 	return std::move(result);
 }
 
@@ -615,11 +2697,10 @@ static OperatorResultType ReadTextLinesLateralInOut(ExecutionContext &context, T
 		// state, so the parse position survives this operator's
 		// HAVE_MORE_OUTPUT re-invocations.
 		while (output_row < STANDARD_VECTOR_SIZE && state.file_open) {
-			string line;
-			int64_t line_start_offset;
+			LineRow line;
 			bool have_line;
 			try {
-				have_line = state.reader->NextLine(line, line_start_offset);
+				have_line = state.reader->NextLine(line.data, line.size, line.byte_offset);
 			} catch (std::exception &) {
 				if (!bind_data.ignore_errors) {
 					throw;
@@ -645,7 +2726,7 @@ static OperatorResultType ReadTextLinesLateralInOut(ExecutionContext &context, T
 			}
 
 			// VARCHAR requires valid UTF-8; see ReadTextLinesFunction.
-			if (Utf8Proc::Analyze(line.c_str(), line.size()) == UnicodeType::INVALID) {
+			if (Utf8Proc::Analyze(line.data, line.size) == UnicodeType::INVALID) {
 				if (bind_data.ignore_errors) {
 					continue;
 				}
@@ -654,10 +2735,8 @@ static OperatorResultType ReadTextLinesLateralInOut(ExecutionContext &context, T
 			}
 
 			// Output the line
-			output.data[0].SetValue(output_row, Value::BIGINT(state.current_line_number));
-			output.data[1].SetValue(output_row, Value(ApplyLineTrim(line, bind_data.trim_mode)));
-			output.data[2].SetValue(output_row, Value::BIGINT(line_start_offset));
-			output.data[3].SetValue(output_row, Value(state.current_file_path));
+			line.line_number = state.current_line_number;
+			state.writer.Write(output, output_row, LATERAL_COLUMNS, line, state.current_file_path);
 
 			output_row++;
 		}
@@ -1,7 +1,9 @@
 #define DUCKDB_EXTENSION_MAIN
 
 #include "read_lines_extension.hpp"
+#include "line_glob_cache.hpp"
 #include "duckdb.hpp"
+#include "duckdb/main/config.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/function/function_set.hpp"
@@ -12,6 +14,8 @@ namespace duckdb {
 TableFunctionSet ReadLinesFunction();
 TableFunctionSet ReadLinesLateralFunction();
 TableFunction ParseLinesFunction();
+TableFunction BuildNgramIndexFunction();
+TableFunction BuildTimeIndexFunction();
 
 void ReadLinesExtension::Load(ExtensionLoader &loader) {
 	// Register read_lines table function
@@ -22,6 +26,17 @@ void ReadLinesExtension::Load(ExtensionLoader &loader) {
 
 	// Register parse_lines table function
 	loader.RegisterFunction(ParseLinesFunction());
+
+	// Register build_ngram_index / build_time_index to pre-index files for
+	// filtered scans
+	loader.RegisterFunction(BuildNgramIndexFunction());
+	loader.RegisterFunction(BuildTimeIndexFunction());
+
+	// Reuse of glob listings across queries; off (0) by default
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption(GLOB_CACHE_TTL_SETTING,
+	                          "How long read_lines may reuse the files a path pattern matched (0 to always re-list)",
+	                          LogicalType::INTERVAL, Value::INTERVAL(0, 0, 0));
 }
 
 std::string ReadLinesExtension::Name() {